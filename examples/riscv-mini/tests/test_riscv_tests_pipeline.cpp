@@ -203,21 +203,14 @@ bool run_riscv_test_pipeline(const std::string& test_name, const std::string& bi
     sim.tick();
     sim.set_input_value(top.instance().io().dtcm_write_en, 0);
 
-    uint32_t tohost_value = 0;
-    bool test_complete = false;
-
-    for (uint32_t tick = 0; tick < MAX_TICKS && !test_complete; tick++) {
-        sim.tick();
-
-        sim.set_input_value(top.instance().io().dtcm_read_addr, RV32I_TOHOST_ADDR / 4);
-        sim.tick();
-        auto val = sim.get_port_value(top.instance().io().dtcm_read_data);
-        tohost_value = static_cast<uint64_t>(val);
-
-        if (tohost_value != 0) {
-            test_complete = true;
-        }
-    }
+    // 读端口固定指向 tohost，由仿真器内部逐拍检查读数据（ADR-040），
+    // 不再每拍往返一次 tick() + get_port_value()
+    sim.set_input_value(top.instance().io().dtcm_read_addr, RV32I_TOHOST_ADDR / 4);
+    sim.watch_not_equals(top.instance().io().dtcm_read_data, 0);
+    sim.run_until(2ull * MAX_TICKS);
+    const bool test_complete = sim.last_stop_watch() >= 0;
+    const uint32_t tohost_value = static_cast<uint32_t>(
+        static_cast<uint64_t>(sim.get_port_value(top.instance().io().dtcm_read_data)));
 
     result.test_name = test_name;
     result.passed = false;
@@ -20,6 +20,14 @@ public:
     // 获取上一时钟状态
     bool last_clock_value() const { return last_clk_; }
 
+    // ADR-038: 检查点恢复沿检测状态
+    void restore_state(bool last_clk, bool posedge_active,
+                       bool negedge_active) {
+        last_clk_ = last_clk;
+        posedge_active_ = posedge_active;
+        negedge_active_ = negedge_active;
+    }
+
 private:
     ch::core::sdata_type *clock_buf_;
     bool is_posedge_;
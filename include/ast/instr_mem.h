@@ -4,6 +4,7 @@
 #include "instr_base.h"
 #include "types.h"
 #include <cstdint>
+#include <memory>
 #include <vector>
 #include <unordered_map>
 
@@ -23,8 +24,11 @@ using ch::core::sdata_type;
         uint32_t depth_;
         bool is_rom_;
 
-        // 内存存储 - 直接使用vector<sdata_type>
-        std::vector<sdata_type> memory_;
+        // 内存存储 - vector<sdata_type>，ADR-038: 写时复制，fork() 出的
+        // 仿真器共享同一块存储，直到任一方第一次写入
+        std::shared_ptr<std::vector<sdata_type>> memory_;
+
+        std::vector<sdata_type> &writable_memory();
 
     public:
         // 构造函数 - 接收vector格式的初始化数据
@@ -40,10 +44,16 @@ using ch::core::sdata_type;
         bool is_rom() const { return is_rom_; }
 
         // 内存访问接口
-        sdata_type *get_memory() { return memory_.data(); }
-        const sdata_type *get_memory() const { return memory_.data(); }
-        sdata_type &get_data(uint32_t addr) { return memory_.at(addr); }
-        const sdata_type &get_data(uint32_t addr) const { return memory_.at(addr); }
+        sdata_type *get_memory() { return writable_memory().data(); }
+        const sdata_type *get_memory() const { return memory_->data(); }
+        sdata_type &get_data(uint32_t addr) { return writable_memory().at(addr); }
+        const sdata_type &get_data(uint32_t addr) const { return memory_->at(addr); }
+
+        // ADR-038: 与 other 共享存储内容（写时复制）
+        void share_memory(const instr_mem &other) { memory_ = other.memory_; }
+        bool shares_memory_with(const instr_mem &other) const {
+            return memory_ == other.memory_;
+        }
 
         uint32_t get_address(const sdata_type &addr_data) const;
 
@@ -1,17 +1,34 @@
 // include/ast/instr_op_arith.h
 // Phase 7: Arithmetic op structs (Add, Sub, Mul, Div, Mod, Neg).
+// Mul/Div/Mod are width-specialized: single-word operands take a native
+// uint64_t path; only wider operands touch the multiword bv_* kernels.
 // Split from instr_op.h to keep each file <200 lines per Phase 7 plan.
 #pragma once
 
 #include "instr_base.h"
 #include "logger.h"
+#include <algorithm>
 #include <cstdint>
-#include <iostream>
 #include <type_traits>
 
 namespace ch {
 namespace op {
 
+namespace detail {
+inline uint64_t arith_mask(uint32_t bw) {
+    return (bw < 64) ? ((1ULL << bw) - 1ULL) : ~0ULL;
+}
+
+// True when dst and both sources fit in a single 64-bit word; such ops are
+// evaluated natively and masked, exactly like the JIT lowering.
+inline bool arith_fits_word(const core::sdata_type *dst,
+                            const core::sdata_type *src0,
+                            const core::sdata_type *src1) {
+    return dst->bitwidth() <= 64 && src0->bitwidth() <= 64 &&
+           src1->bitwidth() <= 64;
+}
+} // namespace detail
+
 // ADD
 // dst is sized to the compile-time result bitwidth; bv_add_truncate
 // truncates the natural max(lhs,rhs)+1 result to dst->size() (matches JIT
@@ -36,42 +53,68 @@ struct Sub {
 };
 
 // MUL
-// dst is sized to the compile-time result bitwidth; bv_mul_truncate
-// truncates the natural lhs+lhs result to dst->size() (matches JIT mask
-// to bitwidth).
+// dst is sized to the compile-time result bitwidth. Operands that fit in a
+// word multiply natively (mod 2^64, then masked — matches the JIT); wider
+// operands go through bv_mul_truncate.
 struct Mul {
     static const char *name() { return "instr_op_mul::eval"; }
     static void eval(core::sdata_type *dst, core::sdata_type *src0,
                      core::sdata_type *src1) {
+        if (detail::arith_fits_word(dst, src0, src1)) {
+            dst->bv_.words()[0] = (src0->bv_.words()[0] * src1->bv_.words()[0]) &
+                                  detail::arith_mask(dst->bitwidth());
+            return;
+        }
         ::ch::internal::bv_mul_truncate<uint64_t>(&dst->bv_, &src0->bv_, &src1->bv_);
     }
 };
 
 // DIV (除法)
+// Division by zero follows the hardware (RISC-V DIVU) convention shared
+// with the JIT lowering: the quotient is all ones at dst width. Word-sized
+// operands divide natively; wider ones use bv_udiv, which truncates into
+// dst in place and uses a stack scratch buffer up to 1024-bit operands
+// (beyond that, a per-thread buffer that grows on first use). Nothing is
+// logged on this path.
 struct Div {
     static const char *name() { return "instr_op_div::eval"; }
     static void eval(core::sdata_type *dst, core::sdata_type *src0,
                      core::sdata_type *src1) {
+        if (detail::arith_fits_word(dst, src0, src1)) {
+            uint64_t b = src1->bv_.words()[0];
+            uint64_t q = b ? src0->bv_.words()[0] / b : ~0ULL;
+            dst->bv_.words()[0] = q & detail::arith_mask(dst->bitwidth());
+            return;
+        }
         if (src1->is_zero()) {
-            std::cerr << "[instr_op_div] Error: Division by zero!" << std::endl;
-            *dst = core::sdata_type(0, dst->bitwidth());
+            uint64_t *words = dst->bv_.words();
+            std::fill_n(words, dst->bv_.num_words(), ~0ULL);
+            ::ch::internal::bv_clear_extra_bits(words, dst->bitwidth());
             return;
         }
-        *dst = *src0 / *src1;
+        ::ch::internal::bv_div_truncate<uint64_t>(&dst->bv_, &src0->bv_, &src1->bv_);
     }
 };
 
 // MOD (取模)
+// Modulo by zero yields the dividend truncated to dst width (RISC-V REMU),
+// matching the JIT select. Same word / multiword split as Div.
 struct Mod {
     static const char *name() { return "instr_op_mod::eval"; }
     static void eval(core::sdata_type *dst, core::sdata_type *src0,
                      core::sdata_type *src1) {
+        if (detail::arith_fits_word(dst, src0, src1)) {
+            uint64_t a = src0->bv_.words()[0];
+            uint64_t b = src1->bv_.words()[0];
+            dst->bv_.words()[0] =
+                (b ? a % b : a) & detail::arith_mask(dst->bitwidth());
+            return;
+        }
         if (src1->is_zero()) {
-            std::cerr << "[instr_op_mod] Error: Modulo by zero!" << std::endl;
-            *dst = core::sdata_type(0, dst->bitwidth());
+            ::ch::internal::bv_assign_truncate<uint64_t>(&dst->bv_, &src0->bv_);
             return;
         }
-        *dst = *src0 % *src1;
+        ::ch::internal::bv_mod_truncate<uint64_t>(&dst->bv_, &src0->bv_, &src1->bv_);
     }
 };
 
@@ -68,17 +68,37 @@ struct RotateRight {
 };
 
 // SSHR (算术右移)
+// Single-word operands sign-extend from src0's width and shift natively,
+// then mask to dst width — the same sequence the JIT lowering emits. Shift
+// amounts >= the source width saturate to all sign bits (Verilog `>>>`).
+// Wider operands keep the multiword shift + sign fill.
 struct Sshr {
     static const char *name() { return "instr_op_sshr::eval"; }
     static void eval(core::sdata_type *dst, core::sdata_type *src0,
                      core::sdata_type *src1) {
         uint64_t shift = static_cast<uint64_t>(*src1);
-        bool sign_bit = src0->get_bit(src0->bitwidth() - 1);
+        const uint32_t src_bw = src0->bitwidth();
+        if (dst->bitwidth() <= 64 && src_bw <= 64) {
+            uint64_t val = src0->bv_.words()[0];
+            if (src_bw < 64 && ((val >> (src_bw - 1)) & 1ULL))
+                val |= ~0ULL << src_bw;
+            uint64_t sh = shift > 63 ? 63 : shift;
+            uint64_t res = static_cast<uint64_t>(static_cast<int64_t>(val) >>
+                                                 static_cast<int>(sh));
+            uint32_t dst_bw = dst->bitwidth();
+            dst->bv_.words()[0] =
+                res & ((dst_bw < 64) ? ((1ULL << dst_bw) - 1ULL) : ~0ULL);
+            return;
+        }
+
+        bool sign_bit = src0->get_bit(src_bw - 1);
         *dst = (*src0) >> static_cast<uint32_t>(shift);
 
-        if (sign_bit && shift > 0 && shift < src0->bitwidth()) {
-            for (uint32_t i = src0->bitwidth() - static_cast<uint32_t>(shift);
-                 i < src0->bitwidth(); ++i) {
+        if (sign_bit && shift > 0) {
+            uint32_t first = shift < src_bw
+                                 ? src_bw - static_cast<uint32_t>(shift)
+                                 : 0u;
+            for (uint32_t i = first; i < src_bw; ++i) {
                 dst->set_bit(i, true);
             }
         }
@@ -6,6 +6,7 @@
 #include "bv_pad_slice.h"
 #include <algorithm>
 #include <cstring>
+#include <limits>
 #include <stdexcept>
 #include <type_traits>
 #include <vector>
@@ -256,6 +257,13 @@ void bv_mul(T *out, uint32_t out_size, const T *lhs, uint32_t lhs_size,
 
 ///////////////////////////////////////////////////////////////////////////////
 
+// Unsigned long division (Knuth algorithm D, Hacker's Delight divmnu).
+// quot/rem are written truncated to quot_size/rem_size bits; either may be
+// null with a zero size. Single-digit divisors take a short-division path.
+// The normalized operands for the general case live in a stack buffer when
+// both operands are up to 1024 bits; wider ones spill to a per-thread
+// vector, so the first such divide on each thread, and any larger one later,
+// still allocates.
 template <typename T>
 void bv_udiv(T *quot, uint32_t quot_size, T *rem, uint32_t rem_size,
              const T *lhs, uint32_t lhs_size, const T *rhs, uint32_t rhs_size) {
@@ -269,7 +277,8 @@ void bv_udiv(T *quot, uint32_t quot_size, T *rem, uint32_t rem_size,
     using syword_t = std::make_signed_t<yword_t>;
 
     static constexpr uint32_t XWORD_SIZE = bitwidth_v<xword_t>;
-    static constexpr xword_t XWORD_MAX = std::numeric_limits<xword_t>::max();
+    static constexpr yword_t XWORD_MAX = std::numeric_limits<xword_t>::max();
+    static constexpr yword_t XWORD_BASE = yword_t(XWORD_MAX) + 1;
 
     auto m = ceildiv<int>(bv_msb(lhs, lhs_size) + 1, XWORD_SIZE);
     auto n = ceildiv<int>(bv_msb(rhs, rhs_size) + 1, XWORD_SIZE);
@@ -301,57 +310,87 @@ void bv_udiv(T *quot, uint32_t quot_size, T *rem, uint32_t rem_size,
         return;
     }
 
-    std::vector<xword_t> tu(2 * (m + 1), 0), tv(2 * n, 0);
-    auto un = tu.data();
-    auto vn = tv.data();
+    if (1 == n) {
+        yword_t k(0);
+        for (int j = m - 1; j >= 0; --j) {
+            yword_t w = (k << XWORD_SIZE) | u[j];
+            if (j < qn)
+                q[j] = xword_t(w / v[0]);
+            k = w % v[0];
+        }
+        if (rn)
+            r[0] = xword_t(k);
+        return;
+    }
 
-    int s = count_leading_zeros<xword_t>(v[n - 1]);
-    un[m] = u[m - 1] >> (XWORD_SIZE - s);
-    for (int i = m - 1; i > 0; --i) {
-        un[i] = (u[i] << s) | (u[i - 1] >> (XWORD_SIZE - s));
+    static constexpr int INLINE_XWORDS = 2 * (1024 / XWORD_SIZE + 1);
+    xword_t inline_buf[INLINE_XWORDS];
+    xword_t *un = inline_buf;
+    if (m + 1 + n > INLINE_XWORDS) {
+        thread_local std::vector<xword_t> spill;
+        if (spill.size() < static_cast<size_t>(m + 1 + n)) {
+            spill.resize(m + 1 + n);
+        }
+        un = spill.data();
     }
-    un[0] = u[0] << s;
+    auto vn = un + m + 1;
+
+    // Shifts are done in yword_t so that s == 0 does not shift an xword_t
+    // by its full width.
+    int s = count_leading_zeros<xword_t>(v[n - 1]);
     for (int i = n - 1; i > 0; --i) {
-        vn[i] = (v[i] << s) | (v[i - 1] >> (XWORD_SIZE - s));
+        vn[i] = xword_t((yword_t(v[i]) << s) |
+                        (yword_t(v[i - 1]) >> (XWORD_SIZE - s)));
     }
-    vn[0] = v[0] << s;
-
-    auto h = vn[n - 1];
+    vn[0] = xword_t(yword_t(v[0]) << s);
+    un[m] = xword_t(yword_t(u[m - 1]) >> (XWORD_SIZE - s));
+    for (int i = m - 1; i > 0; --i) {
+        un[i] = xword_t((yword_t(u[i]) << s) |
+                        (yword_t(u[i - 1]) >> (XWORD_SIZE - s)));
+    }
+    un[0] = xword_t(yword_t(u[0]) << s);
 
     for (int j = m - n; j >= 0; --j) {
-        auto w = (yword_t(un[j + n]) << XWORD_SIZE) | un[j + n - 1];
-        auto qhat = w / h;
+        yword_t w = (yword_t(un[j + n]) << XWORD_SIZE) | un[j + n - 1];
+        yword_t qhat = w / vn[n - 1];
+        yword_t rhat = w - qhat * vn[n - 1];
+        while (qhat >= XWORD_BASE ||
+               qhat * vn[n - 2] > ((rhat << XWORD_SIZE) | un[j + n - 2])) {
+            --qhat;
+            rhat += vn[n - 1];
+            if (rhat >= XWORD_BASE)
+                break;
+        }
 
-        xword_t k(0);
+        syword_t k(0), t(0);
         for (int i = 0; i < n; ++i) {
-            auto p = qhat * vn[i];
-            auto w = un[i + j] - k - (p & XWORD_MAX);
-            k = (p >> XWORD_SIZE) - (w >> XWORD_SIZE);
-            un[i + j] = w;
+            yword_t p = qhat * vn[i];
+            t = syword_t(un[i + j]) - k - syword_t(p & XWORD_MAX);
+            un[i + j] = xword_t(t);
+            k = syword_t(p >> XWORD_SIZE) - (t >> XWORD_SIZE);
         }
-
-        syword_t t(un[j + n] - k);
-        un[j + n] = t;
-
-        if (j < qn)
-            q[j] = qhat;
+        t = syword_t(un[j + n]) - k;
+        un[j + n] = xword_t(t);
 
         if (t < 0) {
-            if (j < qn)
-                --q[j];
-            yword_t k(0);
+            --qhat;
+            yword_t c(0);
             for (int i = 0; i < n; ++i) {
-                auto w = un[i + j] + k + vn[i];
-                k = (w >> XWORD_SIZE);
-                un[i + j] = w;
+                yword_t w2 = yword_t(un[i + j]) + vn[i] + c;
+                un[i + j] = xword_t(w2);
+                c = w2 >> XWORD_SIZE;
             }
-            un[j + n] += k;
+            un[j + n] = xword_t(un[j + n] + c);
         }
+
+        if (j < qn)
+            q[j] = xword_t(qhat);
     }
 
     if (rn) {
         for (int i = 0; i < std::min(n, rn); ++i) {
-            r[i] = (un[i] >> s) | (un[i + 1] << (XWORD_SIZE - s));
+            r[i] = xword_t((yword_t(un[i]) >> s) |
+                           (yword_t(un[i + 1]) << (XWORD_SIZE - s)));
         }
     }
 }
@@ -174,31 +174,15 @@ void bv_div_truncate(bitvector<T> *dst, const bitvector<T> *lhs,
     if (!dst || !lhs || !rhs)
         return;
 
-    static constexpr uint32_t WORD_SIZE = bitwidth_v<T>;
     const uint32_t dst_size = dst->size();
-    const uint32_t lhs_size = lhs->size();
-    const uint32_t rhs_size = rhs->size();
-
     if (dst_size == 0)
         return;
 
-    uint32_t full_result_width = lhs_size;
-
-    if (dst_size >= full_result_width) {
-        bv_div<false>(dst->words(), dst_size, lhs->words(), lhs_size,
-                      rhs->words(), rhs_size);
-        bv_clear_extra_bits(dst->words(), dst_size);
-        return;
-    }
-
-    uint32_t temp_num_words = ceildiv(full_result_width, WORD_SIZE);
-    std::vector<T> temp_words(temp_num_words, T(0));
-
-    bv_div<false>(temp_words.data(), full_result_width, lhs->words(), lhs_size,
-                  rhs->words(), rhs_size);
-
-    bv_assign_truncate<T>(dst->words(), dst_size, temp_words.data(),
-                          full_result_width);
+    // bv_udiv writes the quotient truncated to the requested size, so a
+    // narrower dst needs no temporary full-width buffer.
+    bv_div<false>(dst->words(), dst_size, lhs->words(), lhs->size(),
+                  rhs->words(), rhs->size());
+    bv_clear_extra_bits(dst->words(), dst_size);
 }
 
 // Performs modulo: dst = lhs % rhs
@@ -208,31 +192,15 @@ void bv_mod_truncate(bitvector<T> *dst, const bitvector<T> *lhs,
     if (!dst || !lhs || !rhs)
         return;
 
-    static constexpr uint32_t WORD_SIZE = bitwidth_v<T>;
     const uint32_t dst_size = dst->size();
-    const uint32_t lhs_size = lhs->size();
-    const uint32_t rhs_size = rhs->size();
-
     if (dst_size == 0)
         return;
 
-    uint32_t full_result_width = rhs_size;
-
-    if (dst_size >= full_result_width) {
-        bv_mod<false>(dst->words(), dst_size, lhs->words(), lhs_size,
-                      rhs->words(), rhs_size);
-        bv_clear_extra_bits(dst->words(), dst_size);
-        return;
-    }
-
-    uint32_t temp_num_words = ceildiv(full_result_width, WORD_SIZE);
-    std::vector<T> temp_words(temp_num_words, T(0));
-
-    bv_mod<false>(temp_words.data(), full_result_width, lhs->words(), lhs_size,
-                  rhs->words(), rhs_size);
-
-    bv_assign_truncate<T>(dst->words(), dst_size, temp_words.data(),
-                          full_result_width);
+    // bv_udiv writes the remainder truncated to the requested size, so a
+    // narrower dst needs no temporary full-width buffer.
+    bv_mod<false>(dst->words(), dst_size, lhs->words(), lhs->size(),
+                  rhs->words(), rhs->size());
+    bv_clear_extra_bits(dst->words(), dst_size);
 }
 
 } // namespace internal
@@ -4,6 +4,7 @@
 #include "chlib/logic.h"
 #include "chlib/memory.h"
 #include "component.h"
+#include "core/clock_domain.h"
 #include "core/bool.h"
 #include "core/context.h"
 #include "core/literal.h"
@@ -177,242 +178,96 @@ fwft_fifo(ch_bool wren, ch_uint<DATA_WIDTH> din, ch_bool rden) {
 }
 
 /**
- * 异步 FIFO — 未实现（因 CppHDL 不支持 CDC）
+ * 异步 FIFO - 双时钟域（ADR-036）
  *
- * ❌ CppHDL 当前不支持多时钟域，因此不提供真正的异步 FIFO。
+ * 写端口工作在 wr_clk，读端口工作在 rd_clk，按 StreamFifoCC 的经典结构实现:
+ * - 读写指针为 ADDR_WIDTH+1 位二进制计数器，额外的最高位区分满/空
+ * - 指针以格雷码寄存后跨域，经目标域两级同步器（BufferCC）进入比较
+ * - full 在写时钟域产生：写格雷指针 == 同步后读格雷指针的高两位取反
+ * - empty 在读时钟域产生：读格雷指针 == 同步后的写格雷指针
+ * - q 为同步读端口（读时钟域），始终输出 rd_ptr 处的数据（FWFT）
  *
- * 原因: 没有 ClockDomain 对象、同步器原语、格雷码计数器基础设施。
- * 如果提供"假异步 FIFO"，会在跨时钟域时产生不可调试的静默数据损坏。
- *
- * 参见: docs/adr/ADR-008-single-clock-domain-constraint.md
- *
- * 临时替代方案:
- * - 使用同步 FIFO（sync_fifo / fwft_fifo）+ 单时钟域设计
- * - 使用外部异步 FIFO IP（如 Xilinx FIFO Generator）
- * - 使用 SpinalHDL 的 StreamFifoCC 组件
- *
- * 恢复条件（CDC 基础设施就绪后）:
- * 1. ClockDomain 对象实现
- * 2. 同步器原语（BufferCC）实现
- * 3. 格雷码计数器实现
- * 4. 基于 SpinalHDL StreamFifoCC 模式重新实现 async_fifo
- */
-
-/**
- * 异步 FIFO — 未实现（因 CppHDL 不支持 CDC）
- *
- * ❌ CppHDL 当前不支持多时钟域，因此不提供真正的异步 FIFO。
- *
- * 参见: docs/adr/ADR-008-single-clock-domain-constraint.md
- *
- * 临时替代方案:
- * - 使用同步 FIFO（sync_fifo / fwft_fifo）+ 单时钟域设计
- * - 使用外部异步 FIFO IP（如 Xilinx FIFO Generator）
- * - 使用 SpinalHDL 的 StreamFifoCC 组件
- * 
- * 未来实现计划:
- * 1. 添加格雷码计数器用于跨时钟域指针传输
- * 2. 实现两级/多级同步器用于控制信号
- * 3. 添加空满标志生成逻辑（基于格雷码比较）
- * 4. 验证建立/保持时间约束
- * 
- * 临时替代方案:
- * - 使用同步 FIFO + 时钟分配合并
- * - 使用外部异步 FIFO IP（如 Xilinx FIFO Generator）
- * - 使用 SpinalHDL 的 AsyncFifo 组件
+ * 由于同步器延迟，full/empty 是保守的：写入后至少两个读时钟沿 empty 才会
+ * 撤销。仿真时用 Simulator::set_clock_period() 给两个时钟不同的周期。
  */
-
-/**
- * 异步 FIFO - 异步读写操作
- * 
- * ⚠️ 限制说明:
- * - 当前版本不支持真正的双时钟域 CDC（Clock Domain Crossing）
- * - 需要额外的格雷码计数器和多级同步器逻辑
- * - 建议使用外部异步 FIFO IP 或 SpinalHDL 实现
- * 
- * 未来实现计划:
- * 1. 添加格雷码计数器用于跨时钟域指针传输
- * 2. 实现两级/多级同步器用于控制信号
- * 3. 添加空满标志生成逻辑（基于格雷码比较）
- * 4. 验证建立/保持时间约束
- * 
- * 临时替代方案:
- * - 使用同步 FIFO + 时钟分配合并
- * - 使用外部异步 FIFO IP（如 Xilinx FIFO Generator）
- * - 使用 SpinalHDL 的 AsyncFifo 组件
- */
-
-/**
- * 异步 FIFO - 异步读写操作
- * 
- * ⚠️ 限制说明:
- * - 当前版本不支持真正的双时钟域 CDC（Clock Domain Crossing）
- * - 需要额外的格雷码计数器和多级同步器逻辑
- * - 建议使用外部异步 FIFO IP 或 SpinalHDL 实现
- * 
- * 未来实现计划:
- * 1. 添加格雷码计数器用于跨时钟域指针传输
- * 2. 实现两级/多级同步器用于控制信号
- * 3. 添加空满标志生成逻辑（基于格雷码比较）
- * 4. 验证建立/保持时间约束
- * 
- * 临时替代方案:
- * - 使用同步 FIFO + 时钟分配合并
- * - 使用外部异步 FIFO IP（如 Xilinx FIFO Generator）
- * - 使用 SpinalHDL 的 AsyncFifo 组件
- */
-
-/**
- * 异步 FIFO - 异步读写操作
- * 
- * ⚠️ 限制说明:
- * - 当前版本不支持真正的双时钟域 CDC（Clock Domain Crossing）
- * - 需要额外的格雷码计数器和多级同步器逻辑
- * - 建议使用外部异步 FIFO IP 或 SpinalHDL 实现
- * 
- * 未来实现计划:
- * 1. 添加格雷码计数器用于跨时钟域指针传输
- * 2. 实现两级/多级同步器用于控制信号
- * 3. 添加空满标志生成逻辑（基于格雷码比较）
- * 4. 验证建立/保持时间约束
- * 
- * 临时替代方案:
- * - 使用同步 FIFO + 时钟分配合并
- * - 使用外部异步 FIFO IP（如 Xilinx FIFO Generator）
- * - 使用 SpinalHDL 的 AsyncFifo 组件
- */
-
-/**
- * 异步 FIFO - 异步读写操作
- * 
- * ⚠️ 限制说明:
- * - 当前版本不支持真正的双时钟域 CDC（Clock Domain Crossing）
- * - 需要额外的格雷码计数器和多级同步器逻辑
- * - 建议使用外部异步 FIFO IP 或 SpinalHDL 实现
- * 
- * 未来实现计划:
- * 1. 添加格雷码计数器用于跨时钟域指针传输
- * 2. 实现两级/多级同步器用于控制信号
- * 3. 添加空满标志生成逻辑（基于格雷码比较）
- * 4. 验证建立/保持时间约束
- * 
- * 临时替代方案:
- * - 使用同步 FIFO + 时钟分配合并
- * - 使用外部异步 FIFO IP（如 Xilinx FIFO Generator）
- * - 使用 SpinalHDL 的 AsyncFifo 组件
- */
-
-/*
 template <unsigned DATA_WIDTH, unsigned ADDR_WIDTH> struct AsyncFifoResult {
-    ch_bool empty;
-    ch_bool full;
+    ch_bool empty; // 读时钟域
+    ch_bool full;  // 写时钟域
     ch_uint<DATA_WIDTH> q;
 };
 
+template <unsigned ADDR_WIDTH>
+ch_uint<ADDR_WIDTH + 1> async_fifo_to_gray(ch_uint<ADDR_WIDTH + 1> binary) {
+    return binary ^ (binary >> 1_d);
+}
+
 template <unsigned DATA_WIDTH, unsigned ADDR_WIDTH>
 AsyncFifoResult<DATA_WIDTH, ADDR_WIDTH>
-async_fifo(ch_bool wr_clk, ch_bool wr_rst, ch_bool wren,
-           ch_uint<DATA_WIDTH> din, ch_bool rd_clk, ch_bool rd_rst,
-           ch_bool rden) {
+async_fifo(clockimpl *wr_clk, ch_bool wren, ch_uint<DATA_WIDTH> din,
+           clockimpl *rd_clk, ch_bool rden) {
     static_assert(DATA_WIDTH > 0, "Data width must be greater than 0");
     static_assert(ADDR_WIDTH > 0, "Address width must be greater than 0");
+    static constexpr unsigned PTR_WIDTH = ADDR_WIDTH + 1;
+    // 格雷码满条件：高两位取反，其余位相同
+    static constexpr uint64_t FULL_MASK = 3ULL << (PTR_WIDTH - 2);
 
-    // 内部存储器
-    ch_mem<(1ULL << ADDR_WIDTH), DATA_WIDTH> memory("async_fifo_memory");
+    ch_mem<ch_uint<DATA_WIDTH>, (1ULL << ADDR_WIDTH)> memory(
+        "async_fifo_memory");
 
     // 写时钟域
-    ch_reg<ch_uint<ADDR_WIDTH>> wr_ptr(0_d, "async_fifo_wr_ptr");
-    ch_reg<ch_uint<ADDR_WIDTH>> rd_ptr_gray_sync(0_d,
-                                                 "async_fifo_rd_ptr_gray_sync");
-    ch_reg<ch_uint<ADDR_WIDTH + 1>> wr_count(0_d, "async_fifo_wr_count");
-
-    // 读时钟域
-    ch_reg<ch_uint<ADDR_WIDTH>> rd_ptr(0_d, "async_fifo_rd_ptr");
-    ch_reg<ch_uint<ADDR_WIDTH>> wr_ptr_gray_sync(0_d,
-                                                 "async_fifo_wr_ptr_gray_sync");
-    ch_reg<ch_uint<ADDR_WIDTH + 1>> rd_count(0_d, "async_fifo_rd_count");
-
-    // 同步器 - 用于跨时钟域传输指针
-    ch_reg<ch_uint<ADDR_WIDTH>> sync_stage1(0_d, "sync_stage1");
-    ch_reg<ch_uint<ADDR_WIDTH>> sync_stage2(0_d, "sync_stage2");
-
-    // 写时钟域逻辑
-    wr_ptr->clk = wr_clk;
-    wr_ptr->rst = wr_rst;
-    rd_ptr_gray_sync->clk = wr_clk;
-    rd_ptr_gray_sync->rst = wr_rst;
-    wr_count->clk = wr_clk;
-    wr_count->rst = wr_rst;
-
-    // 读时钟域逻辑
-    rd_ptr->clk = rd_clk;
-    rd_ptr->rst = rd_rst;
-    wr_ptr_gray_sync->clk = rd_clk;
-    wr_ptr_gray_sync->rst = rd_rst;
-    rd_count->clk = rd_clk;
-    rd_count->rst = rd_rst;
-
-    // 格雷码转换辅助函数（在实际实现中需要）
-    auto to_gray = [](ch_uint<ADDR_WIDTH> binary) -> ch_uint<ADDR_WIDTH> {
-        return binary ^ (binary >> 1_d);
-    };
-
-    auto from_gray = [](ch_uint<ADDR_WIDTH> gray) -> ch_uint<ADDR_WIDTH> {
-        ch_uint<ADDR_WIDTH> binary = gray;
-        for (int i = ADDR_WIDTH - 2; i >= 0; --i) {
-            ch_bool bit = bit_select(binary, i + 1) ^ bit_select(gray, i);
-            binary = binary | (ch_uint<ADDR_WIDTH>(bit) << make_literal(i));
-        }
-        return binary;
-    };
-
-    // 写入操作
-    ch_uint<ADDR_WIDTH> wr_ptr_gray = to_gray(wr_ptr);
-    ch_bool wr_full = (to_gray(rd_ptr_gray_sync) ==
-                       wr_ptr_gray + (1ULL << make_literal(ADDR_WIDTH - 1)));
-    ch_bool write_enable = wren && !wr_full;
+    ch_clock_domain wr_domain(wr_clk);
+    ch_reg<ch_uint<PTR_WIDTH>> wr_ptr(0_d, "async_fifo_wr_ptr");
+    ch_reg<ch_uint<PTR_WIDTH>> wr_ptr_gray(0_d, "async_fifo_wr_ptr_gray");
+    ch_reg<ch_uint<PTR_WIDTH>> rd_gray_sync1(0_d, "async_fifo_rd_gray_sync1");
+    ch_reg<ch_uint<PTR_WIDTH>> rd_gray_sync2(0_d, "async_fifo_rd_gray_sync2");
 
-    memory.write(wr_clk, wr_ptr, din, write_enable);
+    ch_bool full = wr_ptr_gray == (rd_gray_sync2 ^ make_literal<FULL_MASK>());
+    ch_bool write_enable = select(wren, ch_bool(!full), ch_bool(false));
+    memory.write(bits<ADDR_WIDTH - 1, 0>(wr_ptr), din, write_enable);
 
-    // 更新写指针
-    wr_ptr->next = select(write_enable, wr_ptr + 1_d, wr_ptr);
-
-    // 读取操作
-    ch_uint<ADDR_WIDTH> rd_ptr_gray = to_gray(rd_ptr);
-    ch_bool rd_empty = (wr_ptr_gray_sync == rd_ptr_gray);
-    ch_bool read_enable = rden && !rd_empty;
-    ch_uint<DATA_WIDTH> output_data = memory.read(rd_ptr);
-
-    // 更新读指针
-    rd_ptr->next = select(read_enable, rd_ptr + 1_d, rd_ptr);
-
-    // 跨时钟域同步
-    // 同步读指针到写时钟域
-    sync_stage1->clk = wr_clk;
-    sync_stage1->rst = wr_rst;
-    sync_stage2->clk = wr_clk;
-    sync_stage2->rst = wr_rst;
-    sync_stage1->next = to_gray(rd_ptr);
-    sync_stage2->next = sync_stage1;
-    rd_ptr_gray_sync->next = sync_stage2;
-
-    // 同步写指针到读时钟域
-    sync_stage1->clk = rd_clk;
-    sync_stage1->rst = rd_rst;
-    sync_stage2->clk = rd_clk;
-    sync_stage2->rst = rd_rst;
-    sync_stage1->next = wr_ptr_gray;
-    sync_stage2->next = sync_stage1;
-    wr_ptr_gray_sync->next = sync_stage2;
+    ch_uint<PTR_WIDTH> wr_ptr_next = select(write_enable, wr_ptr + 1_d, wr_ptr);
+    wr_ptr->next = wr_ptr_next;
+    wr_ptr_gray->next = async_fifo_to_gray<ADDR_WIDTH>(wr_ptr_next);
 
     AsyncFifoResult<DATA_WIDTH, ADDR_WIDTH> result;
-    result.empty = rd_empty;
-    result.full = wr_full;
-    result.q = output_data;
+    result.full = full;
+
+    {
+        // 读时钟域
+        ch_clock_domain rd_domain(rd_clk);
+        ch_reg<ch_uint<PTR_WIDTH>> rd_ptr(0_d, "async_fifo_rd_ptr");
+        ch_reg<ch_uint<PTR_WIDTH>> rd_ptr_gray(0_d, "async_fifo_rd_ptr_gray");
+        ch_reg<ch_uint<PTR_WIDTH>> wr_gray_sync1(0_d,
+                                                 "async_fifo_wr_gray_sync1");
+        ch_reg<ch_uint<PTR_WIDTH>> wr_gray_sync2(0_d,
+                                                 "async_fifo_wr_gray_sync2");
+
+        ch_bool empty = rd_ptr_gray == wr_gray_sync2;
+        ch_bool read_enable = select(rden, ch_bool(!empty), ch_bool(false));
+
+        ch_uint<PTR_WIDTH> rd_ptr_next =
+            select(read_enable, rd_ptr + 1_d, rd_ptr);
+        rd_ptr->next = rd_ptr_next;
+        rd_ptr_gray->next = async_fifo_to_gray<ADDR_WIDTH>(rd_ptr_next);
+
+        // 两级同步器：写指针进入读时钟域
+        wr_gray_sync1->next = wr_ptr_gray;
+        wr_gray_sync2->next = wr_gray_sync1;
+
+        ch_uint<DATA_WIDTH> read_data;
+        read_data <<= memory.sread(bits<ADDR_WIDTH - 1, 0>(rd_ptr_next),
+                                   ch_bool(true));
+
+        // 两级同步器：读指针进入写时钟域（寄存器已在写时钟域创建）
+        rd_gray_sync1->next = rd_ptr_gray;
+        rd_gray_sync2->next = rd_gray_sync1;
+
+        result.empty = empty;
+        result.q = read_data;
+    }
 
     return result;
 }
-*/
 
 /**
  * LIFO Stack - 后进先出栈
@@ -40,6 +40,11 @@ public:
     // Generates the complete Verilog module and writes it to the given stream.
     void print(std::ostream &out);
 
+    // Verilog identifier assigned to a node (ports keep this name in
+    // `module top`), or an empty string for nodes outside the eval list.
+    // VerilatorBackend uses it to bind Vtop fields to node ids.
+    std::string node_name(ch::core::lnodeimpl *node) const;
+
 private:
     // --- Helper functions for name generation and validation ---
     std::string sanitize_name(const std::string &name) const;
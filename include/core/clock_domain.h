@@ -0,0 +1,81 @@
+// include/core/clock_domain.h
+// ADR-036: 多时钟域前端接口
+//
+//   auto *bus_clk = ch_create_clock("bus_clk");
+//   {
+//       ch_clock_domain cd(bus_clk);      // 作用域内新建的寄存器/存储器端口
+//       ch_reg<ch_uint<8>> r(0_d);        // 都挂在 bus_clk 上
+//   }
+//
+// 时钟节点统一创建在根 context（沿 parent 链向上）中，并按名字复用：
+// 子组件里的 ch_create_clock("bus_clk") 与顶层的同名时钟是同一个时钟域，
+// 仿真器只遍历根 context 的 eval list，时钟必须在那里可见。
+// 周期/相位是仿真属性，由 Simulator::set_clock_period() 配置。
+#pragma once
+
+#include "ast/clockimpl.h"
+#include "core/context.h"
+#include "logger.h"
+#include <source_location>
+#include <string>
+
+namespace ch::core {
+
+inline clockimpl *
+ch_create_clock(const std::string &name, bool posedge = true,
+                const std::source_location &sloc =
+                    std::source_location::current()) {
+    context *ctx = ctx_curr_;
+    if (!ctx) {
+        CHERROR("[ch_create_clock] No active context for clock '%s'",
+                name.c_str());
+        return nullptr;
+    }
+    while (ctx->parent()) {
+        ctx = ctx->parent();
+    }
+
+    for (const auto &node : ctx->get_nodes()) {
+        if (node && node->type() == lnodetype::type_clock &&
+            node->name() == name) {
+            return static_cast<clockimpl *>(node.get());
+        }
+    }
+    auto *clk =
+        ctx->create_clock(sdata_type(0, 1), posedge, !posedge, name, sloc);
+    // 时钟名是全局的（仿真器按名字配置周期），不带组件层次前缀
+    if (clk) {
+        clk->set_name(name);
+    }
+    return clk;
+}
+
+// RAII 时钟域切换：构造时把 clk 设为当前 context 的 current_clock，
+// 析构时恢复。ch_reg 与 ch_mem 端口在构建时读取 current_clock。
+class ch_clock_domain {
+public:
+    explicit ch_clock_domain(clockimpl *clk) : ctx_(ctx_curr_) {
+        if (!ctx_ || !clk) {
+            CHERROR("[ch_clock_domain] Null context or clock");
+            ctx_ = nullptr;
+            return;
+        }
+        saved_ = ctx_->current_clock();
+        ctx_->set_current_clock(clk);
+    }
+
+    ~ch_clock_domain() {
+        if (ctx_) {
+            ctx_->set_current_clock(saved_);
+        }
+    }
+
+    ch_clock_domain(const ch_clock_domain &) = delete;
+    ch_clock_domain &operator=(const ch_clock_domain &) = delete;
+
+private:
+    context *ctx_;
+    clockimpl *saved_ = nullptr;
+};
+
+} // namespace ch::core
@@ -157,12 +157,11 @@ private:
     // ID溢出保护
     static constexpr uint32_t MAX_NODE_ID = UINT32_MAX - 1000;
 
-    // ⚠️ 单时钟域约束：CppHDL 当前仅支持单时钟域
-    // 所有寄存器共享 default_clock_ 和 default_reset_，不支持多时钟设计
-    // 不支持 CDC（Clock Domain Crossing），不支持多时钟 FIFO
-    // 参见: docs/adr/ADR-008-single-clock-domain-constraint.md
-    core::clockimpl *default_clock_ = nullptr; // 默认时钟（唯一）
-    core::resetimpl *default_reset_ = nullptr; // 默认复位（唯一）
+    // 默认时钟域：未显式切换时钟域的寄存器/存储器端口挂在 default_clock_ 上。
+    // 其它时钟由 ch_create_clock() 创建、ch_clock_domain 切换 current_clock_，
+    // 仿真器按时钟域调度（ADR-036，取代 ADR-008 的单时钟域约束）。
+    core::clockimpl *default_clock_ = nullptr; // 默认时钟
+    core::resetimpl *default_reset_ = nullptr; // 默认复位
 };
 
 } // namespace ch::core
@@ -172,13 +172,17 @@ public:
         CHDBG("[node_builder] Building register with size %u, name '%s'", size,
               name.c_str());
 
-        // Check if we have a default clock and reset
-        ch::core::clockimpl *default_clk = ctx->get_default_clock();
+        // ADR-036: 寄存器挂在当前时钟域（ch_clock_domain 可切换），
+        // 未设置时回退到默认时钟
+        ch::core::clockimpl *clk = ctx->current_clock(sloc);
+        if (!clk) {
+            clk = ctx->get_default_clock();
+        }
         ch::core::resetimpl *default_rst = ctx->get_default_reset();
 
         // 构建寄存器节点
         regimpl *reg_node = ctx->create_node<regimpl>(
-            size, default_clk->id(), default_rst, nullptr, nullptr, next_val,
+            size, clk->id(), default_rst, nullptr, nullptr, next_val,
             init_val, prefixed_name_helper(name, name_prefix_), sloc);
 
         // 构建代理节点
@@ -38,6 +38,20 @@ auto shl(const LHS &lhs, const RHS &rhs) {
     return make_uint_result<ResultWidth>(op_node);
 }
 
+// === 带结果位宽模板参数的算术右移操作 ===
+// operator>>> does not exist in C++; this is the explicit-width spelling.
+template <unsigned ResultWidth, ValidOperand LHS, ValidOperand RHS>
+auto sshr(const LHS &lhs, const RHS &rhs) {
+    auto lhs_node = to_operand(lhs);
+    auto rhs_node = to_operand(rhs);
+
+    auto *op_node = node_builder::instance().build_operation(
+        ch_op::sshr, lhs_node, rhs_node, ResultWidth, false, "sshr",
+        std::source_location::current());
+
+    return make_uint_result<ResultWidth>(op_node);
+}
+
 template <ValidOperand LHS, ValidOperand RHS>
 auto operator<<(const LHS &lhs, const RHS &rhs) {
     constexpr unsigned lhs_width = ch_width_v<LHS>;
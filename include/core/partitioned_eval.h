@@ -0,0 +1,112 @@
+// include/core/partitioned_eval.h
+// ADR-037: 多线程分区求值（解释器路径）
+//
+// 组合逻辑图在寄存器边界处切开：寄存器、顶层输入、字面量、时钟/复位与
+// 存储器端口在组合阶段都是只读的，去掉它们之后剩下的组合节点按数据依赖
+// 合并成若干互不相连的簇（cluster）。簇之间没有组合边，可以在同一个阶段
+// 并行求值；跨簇的值只经由寄存器传递，而寄存器只在时序阶段写入、组合阶段
+// 读取——Simulator 原有的 comb / seq 两阶段就是天然的双缓冲，热路径上
+// 不需要任何锁，每个阶段结束时一次屏障即可。
+//
+// 寄存器的 proxy 副本这类"边界节点"（没有组合前驱）如果被多个簇读取，
+// 会把这些簇连成一个大簇；它们改为在组合阶段开头的边界子阶段并行求值，
+// 多一次屏障换取簇的独立。
+//
+// 簇按估算的指令代价做 LPT 装箱分到 N 个分区；在负载不超过上限的前提下
+// 优先放进"它读取的寄存器所在的分区"，以减少跨分区的寄存器边界边
+// （cut edges）。寄存器跟随其 next 所在的簇；存储器端口以及读取其他
+// 时序节点输出的寄存器放在串行列表中，由主线程在并行时序阶段之后执行。
+#pragma once
+
+#include "ast/instr_base.h"
+#include "core/lnodeimpl.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace ch {
+
+struct PartitionStats {
+    unsigned threads = 1;
+    size_t clusters = 0;     // 组合逻辑连通簇数
+    size_t comb_nodes = 0;   // 参与并行求值的组合节点
+    size_t seq_nodes = 0;    // 参与并行求值的时序节点
+    size_t serial_nodes = 0; // 主线程串行执行的时序节点
+    size_t boundary_nodes = 0; // 边界子阶段求值的共享组合节点
+    uint64_t total_cost = 0;
+    uint64_t max_partition_cost = 0;
+    uint64_t max_cluster_cost = 0; // 最大簇的代价决定了可达到的加速上限
+    size_t cut_edges = 0; // 读取者与被读节点（组合节点/寄存器）不在同一分区
+
+    // 负载均衡度：1.0 表示各分区代价完全相同
+    double balance() const {
+        return max_partition_cost == 0
+                   ? 1.0
+                   : static_cast<double>(total_cost) /
+                         (static_cast<double>(max_partition_cost) * threads);
+    }
+};
+
+class PartitionedEvaluator {
+public:
+    using instr_list = std::vector<std::pair<uint32_t, ch::instr_base *>>;
+
+    // threads 包含主线程：threads == 4 时额外启动 3 个工作线程
+    explicit PartitionedEvaluator(unsigned threads);
+    ~PartitionedEvaluator();
+
+    PartitionedEvaluator(const PartitionedEvaluator &) = delete;
+    PartitionedEvaluator &operator=(const PartitionedEvaluator &) = delete;
+
+    // eval_list 用于查节点类型与依赖；comb/seq 为 Simulator 已分类的指令表
+    // （顶层输入指令不在其中，由调用方在组合阶段之前串行执行）
+    void build(const std::vector<ch::core::lnodeimpl *> &eval_list,
+               const instr_list &combinational, const instr_list &sequential);
+
+    void eval_combinational() {
+        if (has_boundary_)
+            run_phase(Phase::Boundary);
+        run_phase(Phase::Comb);
+    }
+    void eval_sequential() {
+        run_phase(Phase::Seq);
+        for (auto *instr : serial_seq_) {
+            instr->eval();
+        }
+    }
+
+    unsigned threads() const { return threads_; }
+    const PartitionStats &stats() const { return stats_; }
+
+private:
+    enum class Phase { Boundary, Comb, Seq, Stop };
+
+    struct Partition {
+        std::vector<ch::instr_base *> boundary;
+        std::vector<ch::instr_base *> comb;
+        std::vector<ch::instr_base *> seq;
+        uint64_t cost = 0;
+    };
+
+    void run_phase(Phase phase);
+    void run_partition(size_t index, Phase phase);
+    void worker_main(size_t index);
+
+    unsigned threads_;
+    std::vector<Partition> partitions_;
+    std::vector<ch::instr_base *> serial_seq_;
+    bool has_boundary_ = false;
+    std::vector<std::thread> workers_;
+    PartitionStats stats_;
+
+    // 主线程写 phase_ 后 release 递增 generation_，工作线程 acquire 后读取
+    Phase phase_ = Phase::Comb;
+    alignas(64) std::atomic<uint32_t> generation_{0};
+    alignas(64) std::atomic<uint32_t> pending_{0};
+};
+
+} // namespace ch
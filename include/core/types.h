@@ -1,6 +1,7 @@
 // include/core/types.h
 #pragma once
 
+#include <bit>
 #include <cstdint>
 #include <iostream>
 #include <string>
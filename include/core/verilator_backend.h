@@ -7,8 +7,11 @@
 // access. The compiled .so is content-addressed (SHA-1) in
 // ~/.cache/cpphdl/verilator/<hash>/ for incremental builds.
 //
-// STATUS (2026-06-07): scaffolding only. The full implementation
-// (Phase 3.2-3.6) follows.
+// Port binding: initialize() emits cpphdl_wrapper.cpp next to top.v.
+// The wrapper is compiled against Vtop.h and exports
+// cpphdl_bind_ports(), which fills a void*[] with &vtop-><port> in the
+// order the backend generated it, so field_ptr needs neither VPI nor
+// knowledge of the Vtop layout on the CppHDL side.
 #pragma once
 
 #include "core/eval_backend.h"
@@ -29,13 +32,15 @@ struct VerilatorTopHandle;
 // SpinalHDL's ISignalAccess (see ADR-035 / Verilator C++ API report).
 struct VerilatorPortAccess {
     void *field_ptr;        // &vtop->port (computed once, O(1) access)
-    uint32_t bitwidth;      // 1, 2, ..., 64
+    uint32_t bitwidth;      // 1..8 CData, ..16 SData, ..32 IData,
+                            // ..64 QData, wider: VlWide (EData words)
     bool is_input;          // true for ch_in, false for ch_out
 };
 
 class VerilatorBackend : public IEvalBackend {
 public:
-    explicit VerilatorBackend(std::string verilog_path = "/tmp/cpphdl_verilator");
+    explicit VerilatorBackend(std::string verilog_path = "/tmp/cpphdl_verilator",
+                              std::string verilator_bin = "verilator");
     ~VerilatorBackend() override;
 
     bool initialize(ch::core::context *ctx,
@@ -73,9 +78,28 @@ public:
     // is unset.
     static std::string cache_path_for_key(const std::string &cache_key);
 
+    // First line of `<verilator_bin> --version` (e.g. "Verilator 5.020
+    // 2024-01-01 rev v5.020"), or empty when the tool cannot be run.
+    // This string is what compute_cache_key() is keyed on.
+    static std::string detect_verilator_version(
+        const std::string &verilator_bin = "verilator");
+
+    // Overrides the cache root ($HOME/.cache/cpphdl/verilator by
+    // default); the cached library is <root>/<key>/Vtop.
+    void set_cache_root(std::string root) { cache_root_ = std::move(root); }
+
     // Path to the compiled .so (or empty if not yet compiled).
     const std::string &compiled_so_path() const { return compiled_so_path_; }
 
+    // Version string detected by the last initialize() (empty when
+    // verilator was not found).
+    const std::string &verilator_version() const { return verilator_version_; }
+
+    // True once the .so is loaded, a Vtop instance exists and every
+    // port has a bound field_ptr. When false the eval_* hooks fall back
+    // to the interpreter instruction lists passed in by the Simulator.
+    bool model_loaded() const { return top_instance_ != nullptr; }
+
     // Snapshot the port access table (Phase 3.3). Returns a copy so
     // callers can inspect bitwidth/is_input without exposing the
     // internal unordered_map. Tests use this to assert the table
@@ -86,10 +110,10 @@ public:
     }
 
     // ADR-035 Phase 3.4: id of the type_clock lnode discovered by
-    // build_port_access_table(), or UINT32_MAX. The 3-eval/tick
-    // model (comb-1, clock, comb-2) maps to Verilator's single-step
-    // eval(); clk manipulation is gated on the field_ptr work in
-    // Phase 3.3.
+    // build_port_access_table(), or UINT32_MAX. Its data_map value is
+    // copied into vtop->default_clock before every eval(), so the
+    // Simulator's 3-eval/tick model (comb-1, clock=1, clock=0) yields
+    // exactly one posedge per tick inside the Verilated model.
     uint32_t clock_node_id() const { return clock_node_id_; }
 
     // ADR-035 Phase 3.6: VCD trace toggle. When enabled, eval
@@ -101,17 +125,31 @@ public:
     bool vcd_enabled() const { return vcd_enabled_; }
 
 private:
+    // Port of `module top` in wrapper order (index into the void*[]
+    // filled by cpphdl_bind_ports()).
+    struct WrapperPort {
+        ch::core::lnodeimpl *node;
+        std::string name;
+    };
+
+    // Hot-path view of port_access_: the data_map buffer is resolved
+    // once so sync_* never hashes.
+    struct BoundPort {
+        void *field_ptr;
+        ch::core::sdata_type *data;
+        uint32_t bitwidth;
+    };
+
     bool generate_verilog(ch::core::context *ctx);
+    bool generate_wrapper();
     bool invoke_verilator(const std::string &verilog_path);
     bool dlopen_top(const std::string &so_path);
     void close_top();
+    std::string cached_library_path(const std::string &key) const;
 
-    // ADR-035 / Phase 3.3: build the port name → node_id map and
-    // populate port_access_ for the loaded Vtop. The actual
-    // field-pointer resolution (binding ch_in<>/ch_out<> names to
-    // &vtop-><field>) requires either VPI lookups or generated
-    // per-design accessors; we record metadata now and document
-    // the binding as Phase 3.3 follow-up.
+    // ADR-035 / Phase 3.3: populate port_access_ from the eval list
+    // and, when a model is loaded, bind each entry's field_ptr from
+    // the wrapper's cpphdl_bind_ports() table.
     void build_port_access_table();
     void sync_inputs_to_vtop();
     void sync_outputs_from_vtop();
@@ -119,11 +157,18 @@ private:
     // dlopen state
     void *dl_handle_ = nullptr;
     void *top_instance_ = nullptr;  // Vtop*
+    void *(*new_fn_)() = nullptr;
     void (*eval_fn_)(void *) = nullptr;
     void (*final_fn_)(void *) = nullptr;
+    void (*delete_fn_)(void *) = nullptr;
+    uint32_t (*port_count_fn_)() = nullptr;
+    void (*bind_ports_fn_)(void *, void **) = nullptr;
 
     // Port access table (node_id -> Vtop field pointer + metadata)
     std::unordered_map<uint32_t, VerilatorPortAccess> port_access_;
+    std::vector<WrapperPort> wrapper_ports_;
+    std::vector<BoundPort> bound_inputs_;   // incl. clock / reset
+    std::vector<BoundPort> bound_outputs_;
 
     // Phase 3.4: id of the type_clock lnode (or UINT32_MAX if none).
     uint32_t clock_node_id_ = UINT32_MAX;
@@ -133,7 +178,10 @@ private:
 
     // Config
     std::string verilator_work_dir_;
+    std::string verilator_bin_;
+    std::string cache_root_;
     std::string compiled_so_path_;
+    std::string verilator_version_;
 
     // State
     ch::core::context *ctx_ = nullptr;
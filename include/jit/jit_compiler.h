@@ -34,6 +34,15 @@ struct JitCompileResult {
                          ir_instr_count(0), vreg_count(0) {}
 };
 
+// ADR-036: 每个时钟域一个时序函数。默认时钟域固定为 "tick_seq"（下标 0），
+// 其它时钟域为 "tick_seq_<时钟名>"。
+struct JitSeqDomain {
+    uint32_t clock_id = 0;
+    std::string func_name;
+    void* func = nullptr;
+    uint32_t ir_instr_count = 0;
+};
+
 class JitCompiler {
 public:
     // Small graphs (depth=10, ~30 nodes) lose to interpreter because
@@ -56,12 +65,20 @@ public:
 
     void execute_tick();
     void execute_comb_tick();
+    // 执行所有时钟域的时序函数（单时钟调度的语义）
     void execute_seq_tick();
+    // 只执行 clock_id 所在时钟域的时序函数（多时钟调度）
+    void execute_seq_tick(uint32_t clock_id);
 
     bool has_comb_func() const { return compiled_comb_func_ != nullptr; }
     bool has_seq_func() const { return compiled_seq_func_ != nullptr; }
+    bool has_seq_func_for(uint32_t clock_id) const;
+    const std::vector<JitSeqDomain>& seq_domains() const { return seq_domains_; }
 
     void clear();
+    // ADR-038: Simulator::fork() 使用。新对象与本对象共享已编译的代码
+    // （LLJIT 会话按引用计数保活），data_buffer_ 按值复制，不重新编译
+    std::unique_ptr<JitCompiler> clone() const;
     uint32_t get_ir_instr_count() const { return last_ir_instr_count_; }
     uint32_t get_seq_ir_instr_count() const { return last_seq_ir_instr_count_; }
     const std::string& last_error_msg() const { return last_error_msg_; }
@@ -75,10 +92,12 @@ public:
 
     // 查询需要解释器回退的外部节点
     bool is_external_node(uint32_t node_id) const;
+    bool has_external_nodes() const { return !external_node_ids_.empty(); }
 
 private:
     bool available_;
     void* jit_session_;
+    std::shared_ptr<void> session_ref_; // 持有 jit_session_，clone() 共享
     void* compiled_func_;
     void* compiled_comb_func_;
     void* compiled_seq_func_;
@@ -88,6 +107,7 @@ private:
     std::string last_error_msg_;
 
     std::vector<uint64_t> data_buffer_;
+    std::vector<JitSeqDomain> seq_domains_;
 
     // CALL_EXTERNAL 操作的外部节点 ID 集合（需要解释器回退）
     std::unordered_set<uint32_t> external_node_ids_;
@@ -97,8 +117,10 @@ private:
 #endif
 
     JitResult allocate_buffer(ch::core::context* ctx);
-    JitResult generate_ir(ch::core::context* ctx, JitFunction& func_comb, JitFunction& func_seq);
-    JitResult compile_to_llvm(const JitFunction& func_comb, const JitFunction& func_seq);
+    JitResult generate_ir(ch::core::context* ctx, JitFunction& func_comb,
+                          std::vector<JitFunction>& seq_funcs);
+    JitResult compile_to_llvm(const JitFunction& func_comb,
+                              const std::vector<JitFunction>& seq_funcs);
     JitResult finalize_compilation_dual();
 };
 
@@ -6,6 +6,7 @@
 #include "core/bundle/bundle_base.h"
 #include "core/context.h"
 #include "core/eval_backend.h" // ADR-035: IEvalBackend for pluggable backends
+#include "core/partitioned_eval.h" // ADR-037: 多线程分区求值
 #include "core/io.h"
 #include "core/reg.h"
 #include "core/types.h"
@@ -21,6 +22,7 @@
 #include <bitset>
 #include <cstdint>
 #include <deque>
+#include <functional>
 #include <map>
 #include <memory>
 #include <set>
@@ -107,6 +109,84 @@ public:
     IEvalBackend *backend() const { return backend_.get(); }
     const std::string &active_backend_name() const;
 
+    // ADR-036: 多时钟域调度。给任一时钟设置周期后进入多时钟模式：
+    // tick() 推进到下一个时钟沿事件，只求值该时刻有沿的时钟域的寄存器
+    // 与存储器端口（JIT 下调用对应的 tick_seq_<domain>）。未配置周期的
+    // 时钟域沿用默认时钟的周期（默认时钟也未配置时为 1）。
+    // 未调用 set_clock_period() 时保持原有的单时钟 tick 语义。
+    bool set_clock_period(const std::string &clock_name, uint64_t period,
+                          uint64_t phase = 0);
+    bool set_clock_period(const ch::core::clockimpl *clk, uint64_t period,
+                          uint64_t phase = 0);
+    bool is_multi_clock() const { return multi_clock_; }
+    uint64_t sim_time() const { return sim_time_; }
+    size_t clock_domain_count() const { return clock_domains_.size(); }
+    uint64_t clock_edge_count(const std::string &clock_name) const;
+    // 推进 duration 个时间单位，处理这段时间内（左闭右开）的全部沿；
+    // 从 0 时刻开始 run_for(10) 对周期为 1 的时钟恰好产生 10 个沿
+    void run_for(uint64_t duration);
+    // 关闭后每个沿事件求值全部时序指令（寄存器依赖自身时钟判断是否更新），
+    // 仅用于基准对比与排查
+    void set_skip_idle_domains(bool enable) { skip_idle_domains_ = enable; }
+
+    // ADR-037: 多线程分区求值。threads >= 1 时把组合逻辑在寄存器边界处
+    // 划分为 threads 个分区，每个阶段（comb / seq）并行求值后做一次屏障；
+    // threads == 1 走同一条分区路径但不启动工作线程，作为扩展性基线。
+    // 只作用于解释器路径：JIT 已编译并启用时仍走 tick_comb / tick_seq。
+    // threads == 0（默认）恢复原有的逐指令求值循环。
+    void set_num_threads(unsigned threads);
+    unsigned num_threads() const { return num_threads_; }
+    // 未启用分区求值时返回 nullptr
+    const PartitionStats *partition_stats() const {
+        return partitioned_eval_ ? &partitioned_eval_->stats() : nullptr;
+    }
+
+    // ADR-038: 检查点与 fork。检查点保存全部仿真状态：data_map_ 中的节点值、
+    // 存储器内容（只记录非零项）、时钟沿检测状态、时钟域调度状态与 JIT
+    // data_buffer_。文件带版本号与设计哈希，恢复到结构不同的设计会失败。
+    // 通过 set_backend() 接入的外部后端的内部状态不在检查点范围内。
+    bool save_checkpoint(const std::string &path) const;
+    bool restore_checkpoint(const std::string &path);
+    // 在同一 context 上复制出一个状态完全相同的仿真器：不重新 JIT 编译
+    // （共享已编译代码），存储器写时复制，之后两者互不影响；信号跟踪不继承
+    std::unique_ptr<Simulator> fork() const;
+    // 由 eval list 的节点 id / 类型 / 位宽 / 源节点计算
+    uint64_t design_hash() const;
+
+    // ADR-040: 引擎内的条件推进。watch_* 登记停止条件，run_until() 在紧凑
+    // 循环里逐拍推进（没有单拍 tick() 的进度计时与端口查找），每拍之后直接
+    // 读信号缓冲区检查条件，返回实际推进的拍数（命中条件的那一拍计入）；
+    // 命中的条件由 last_stop_watch() 给出，达到 max_ticks 时为 -1。
+    // watch_equals / watch_not_equals 只比较低 64 位；watch_changed 相对
+    // run_until() 开始时的值。on_change() 的回调在信号值变化的那一拍之后
+    // 调用（tick() 与 run_until() 都会触发），不会停止仿真。
+    // signal 可以是端口、ch_uint<N> 或 ch_bool。
+    using watch_id = int;
+    template <typename S>
+    watch_id watch_equals(const S &signal, uint64_t value) {
+        return add_watch(signal.impl(), WatchKind::equals, value, nullptr);
+    }
+    template <typename S>
+    watch_id watch_not_equals(const S &signal, uint64_t value) {
+        return add_watch(signal.impl(), WatchKind::not_equals, value, nullptr);
+    }
+    template <typename S> watch_id watch_changed(const S &signal) {
+        return add_watch(signal.impl(), WatchKind::changed, 0, nullptr);
+    }
+    template <typename S>
+    watch_id on_change(const S &signal,
+                       std::function<void(uint64_t)> callback) {
+        return add_watch(signal.impl(), WatchKind::callback, 0,
+                         std::move(callback));
+    }
+    bool remove_watch(watch_id id);
+    void clear_watches();
+    uint64_t run_until(uint64_t max_ticks);
+    // 任一 watch 命中或 predicate 返回 true 时停止；predicate 每拍调用一次
+    uint64_t run_until(const std::function<bool()> &predicate,
+                       uint64_t max_ticks);
+    watch_id last_stop_watch() const { return last_stop_watch_; }
+
     // 统一的端口值获取接口 - 支持所有端口类型
     template <typename T, typename Dir>
     const ch::core::sdata_type
@@ -519,8 +599,30 @@ public:
 #endif
 
 private:
+    struct fork_tag {};
+    Simulator(const Simulator &parent, fork_tag);
+    void copy_state_from(const Simulator &parent);
+
     void initialize();
     void update_instruction_pointers();
+    void classify_clock_domains();
+    void prepare_clock_schedule();
+    void step_clock_edge();
+    void eval_sequential_domains(const std::vector<size_t> &domains);
+    void build_partitions();
+    // ADR-040: 单拍求值本体与条件推进循环
+    void step();
+    void report_progress();
+    enum class WatchKind { equals, not_equals, changed, callback };
+    watch_id add_watch(ch::core::lnodeimpl *node, WatchKind kind,
+                       uint64_t value, std::function<void(uint64_t)> callback);
+    void resolve_watches();
+    bool check_watches(bool stop_enabled);
+    uint64_t run_ticks(uint64_t max_ticks, bool stop_enabled,
+                       const std::function<bool()> *predicate);
+#if __has_include("jit/jit_compiler.h")
+    uint64_t run_ticks_jit(uint64_t max_ticks, bool stop_enabled);
+#endif
     void collect_signals(); // 收集需要跟踪的信号
     void trace();           // 执行信号跟踪
     // 为Bundle字段设置值的辅助函数
@@ -591,6 +693,45 @@ private:
     std::vector<std::pair<uint32_t, ch::instr_base *>>
         combinational_instr_list_;
 
+    // ADR-036: 时钟域表，clock_domains_[0] 为默认时钟域
+    struct ClockDomain {
+        uint32_t clock_id = 0;
+        std::string name;
+        ch::core::sdata_type *clock_data = nullptr;
+        uint64_t period = 0; // 0 = 未配置
+        uint64_t phase = 0;
+        uint64_t next_edge = 0;
+        uint64_t edge_count = 0;
+        std::vector<std::pair<uint32_t, ch::instr_base *>> seq_instrs;
+    };
+    std::vector<ClockDomain> clock_domains_;
+    std::unordered_map<uint32_t, size_t> clock_domain_index_;
+    std::vector<size_t> edge_domains_; // 当前沿事件涉及的时钟域（复用缓冲）
+    bool multi_clock_ = false;
+    bool schedule_ready_ = false;
+    bool skip_idle_domains_ = true;
+    uint64_t sim_time_ = 0;
+    uint64_t event_floor_ = 0; // 尚未处理的最早时刻
+
+    // ADR-040: 条件推进的 watch 表（data 指向 data_map_ 中的缓冲区）
+    struct Watch {
+        watch_id id = 0;
+        WatchKind kind = WatchKind::equals;
+        uint32_t node_id = 0;
+        const ch::core::sdata_type *data = nullptr;
+        uint64_t value = 0;
+        std::vector<uint64_t> last;
+        std::function<void(uint64_t)> callback;
+    };
+    std::vector<Watch> watches_;
+    size_t callback_watches_ = 0;
+    watch_id next_watch_id_ = 0;
+    watch_id last_stop_watch_ = -1;
+
+    // ADR-037: 分区求值器（num_threads_ == 0 时为空）
+    unsigned num_threads_ = 0;
+    std::unique_ptr<PartitionedEvaluator> partitioned_eval_;
+
     // Add flag to track if we're in the destructor to prevent accessing
     // destroyed context
     bool disconnected_ = false;
@@ -0,0 +1,203 @@
+// include/utils/log_sink.h
+// 异步日志输出：有界 MPSC 环形队列（Vyukov 序号槽）+ 一个后台写线程。
+// 生产者只做一次 CAS 和一次 snprintf 到槽内，不加锁、不分配内存；
+// 队列满时 debug/info 丢弃并计数，warning 及以上让出 CPU 直到有空槽。
+// 由 ch::set_async_logging(true) 启用，默认关闭（同步输出，顺序与旧行为一致）。
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <source_location>
+#include <thread>
+
+namespace ch {
+
+enum class log_level { debug = 0, info = 1, warning = 2, error = 3, fatal = 4 };
+
+namespace detail {
+
+inline const char *log_level_str(log_level level);
+
+class async_log_sink {
+public:
+    static constexpr size_t kSlots = 4096; // 2 的幂
+    static constexpr size_t kTextSize = 256;
+
+    static async_log_sink &instance() {
+        // 故意泄漏：静态析构期间仍可能有日志调用
+        static auto *sink = new async_log_sink;
+        return *sink;
+    }
+
+    bool running() const { return running_.load(std::memory_order_acquire); }
+
+    void start() {
+        bool expected = false;
+        if (!running_.compare_exchange_strong(expected, true)) {
+            return;
+        }
+        stop_.store(false, std::memory_order_relaxed);
+        writer_ = std::thread([this] { run(); });
+        static bool atexit_registered = false;
+        if (!atexit_registered) {
+            atexit_registered = true;
+            std::atexit([] { async_log_sink::instance().stop(); });
+        }
+    }
+
+    void stop() {
+        if (!running_.load(std::memory_order_acquire)) {
+            return;
+        }
+        stop_.store(true, std::memory_order_release);
+        if (writer_.joinable()) {
+            writer_.join();
+        }
+        running_.store(false, std::memory_order_release);
+    }
+
+    // 等待调用前入队的消息全部写出
+    void flush() {
+        const size_t target = enqueue_pos_.load(std::memory_order_acquire);
+        while (running() &&
+               dequeue_pos_.load(std::memory_order_acquire) < target) {
+            std::this_thread::yield();
+        }
+        std::fflush(stdout);
+        std::fflush(stderr);
+    }
+
+    uint64_t dropped() const {
+        return dropped_.load(std::memory_order_relaxed);
+    }
+
+    template <typename... Args>
+    void push(log_level level, const std::source_location *loc,
+              const char *fmt, Args &&...args) {
+        slot *s = nullptr;
+        size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        for (;;) {
+            s = &slots_[pos & (kSlots - 1)];
+            const size_t seq = s->seq.load(std::memory_order_acquire);
+            const auto diff =
+                static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueue_pos_.compare_exchange_weak(
+                        pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                // 队列满
+                if (level < log_level::warning) {
+                    dropped_.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+                std::this_thread::yield();
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            } else {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+
+        int n = 0;
+        if constexpr (sizeof...(Args) == 0) {
+            n = std::snprintf(s->text, kTextSize, "%s", fmt);
+        } else {
+            n = std::snprintf(s->text, kTextSize, fmt, args...);
+        }
+        if (n < 0) {
+            n = 0;
+        }
+        size_t len = static_cast<size_t>(n) < kTextSize
+                         ? static_cast<size_t>(n)
+                         : kTextSize - 1;
+        if (loc && len < kTextSize - 1) {
+            int m = std::snprintf(s->text + len, kTextSize - len, " at %s:%u",
+                                  loc->file_name(),
+                                  static_cast<unsigned>(loc->line()));
+            if (m > 0) {
+                len = std::min(len + static_cast<size_t>(m), kTextSize - 1);
+            }
+        }
+        s->len = static_cast<uint16_t>(len);
+        s->level = level;
+        s->seq.store(pos + 1, std::memory_order_release);
+    }
+
+private:
+    struct slot {
+        std::atomic<size_t> seq{0};
+        log_level level = log_level::info;
+        uint16_t len = 0;
+        char text[kTextSize];
+    };
+
+    async_log_sink() {
+        for (size_t i = 0; i < kSlots; ++i) {
+            slots_[i].seq.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    // 单消费者：按入队顺序写出
+    bool drain_one() {
+        const size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+        slot &s = slots_[pos & (kSlots - 1)];
+        if (s.seq.load(std::memory_order_acquire) != pos + 1) {
+            return false;
+        }
+        FILE *out = s.level <= log_level::info ? stdout : stderr;
+        std::fputs(log_level_str(s.level), out);
+        std::fputc(' ', out);
+        std::fwrite(s.text, 1, s.len, out);
+        std::fputc('\n', out);
+        s.seq.store(pos + kSlots, std::memory_order_release);
+        dequeue_pos_.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    void run() {
+        uint64_t reported_drops = 0;
+        for (;;) {
+            bool any = false;
+            while (drain_one()) {
+                any = true;
+            }
+            const uint64_t drops = dropped();
+            if (drops != reported_drops) {
+                std::fprintf(stderr, "[WARN] %llu log messages dropped\n",
+                             static_cast<unsigned long long>(drops -
+                                                             reported_drops));
+                reported_drops = drops;
+            }
+            if (any) {
+                std::fflush(stdout);
+                continue;
+            }
+            if (stop_.load(std::memory_order_acquire)) {
+                if (!drain_one()) {
+                    break;
+                }
+                continue;
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+        std::fflush(stdout);
+        std::fflush(stderr);
+    }
+
+    slot slots_[kSlots];
+    alignas(64) std::atomic<size_t> enqueue_pos_{0};
+    alignas(64) std::atomic<size_t> dequeue_pos_{0};
+    alignas(64) std::atomic<uint64_t> dropped_{0};
+    std::atomic<bool> running_{false};
+    std::atomic<bool> stop_{false};
+    std::thread writer_;
+};
+
+} // namespace detail
+} // namespace ch
@@ -1,9 +1,10 @@
-// include/logger.h
+// include/utils/logger.h
 #pragma once
 
 #include <cassert>
 #include <cstdint>
 #include <cstdio>
+#include <atomic>
 #include <functional>
 #include <iostream>
 #include <memory>
@@ -13,13 +14,24 @@
 #include <string>
 #include <type_traits>
 
+#include "log_sink.h"
+
 namespace ch {
 
 // ===========================================================================
-// 日志级别定义
+// 日志级别定义（log_level 在 log_sink.h 中）
 // ===========================================================================
 
-enum class log_level { debug = 0, info = 1, warning = 2, error = 3, fatal = 4 };
+// 编译期最低级别：低于它的日志调用整段编译掉，参数不求值、不生成代码。
+// 0=debug … 4=fatal，5=全部关闭。默认 CH_DEBUG 时为 debug，否则为 info，
+// 与旧行为（非 CH_DEBUG 构建不输出 debug）一致。CMake: -DCH_LOG_MIN_LEVEL=N
+#ifndef CH_LOG_MIN_LEVEL
+#ifdef CH_DEBUG
+#define CH_LOG_MIN_LEVEL 0
+#else
+#define CH_LOG_MIN_LEVEL 1
+#endif
+#endif
 
 // ===========================================================================
 // printf 风格的字符串格式化工具
@@ -86,8 +98,66 @@ inline bool &in_static_destruction() {
 
 // Function to set the static destruction flag
 inline void set_static_destruction() { in_static_destruction() = true; }
+
+// 运行期级别阈值：常量初始化，热路径上只是一次 relaxed load。
+// 初值为 debug，即默认只由编译期的 CH_LOG_MIN_LEVEL 决定；初值不能依赖
+// CH_LOG_MIN_LEVEL，否则各翻译单元以不同级别编译时违反 ODR。
+inline std::atomic<int> g_log_threshold{0};
+
+// 环境变量 CPPHDL_LOG_LEVEL=debug|info|warn|error|fatal|off 或 0-5
+inline bool apply_log_level_env() {
+    const char *env = std::getenv("CPPHDL_LOG_LEVEL");
+    if (!env || !*env) {
+        return false;
+    }
+    static const char *const names[] = {"debug", "info", "warn",
+                                        "error", "fatal", "off"};
+    for (int i = 0; i < 6; ++i) {
+        if (std::string(env) == names[i] ||
+            (env[0] == '0' + i && env[1] == '\0')) {
+            g_log_threshold.store(i, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+inline const bool g_log_level_env_applied = apply_log_level_env();
+
+inline bool log_enabled(log_level level) {
+    return static_cast<int>(level) >=
+               g_log_threshold.load(std::memory_order_relaxed) &&
+           !in_static_destruction();
+}
 } // namespace detail
 
+// 运行期调整日志级别（不能低于编译期的 CH_LOG_MIN_LEVEL）
+inline void set_log_level(log_level level) {
+    detail::g_log_threshold.store(static_cast<int>(level),
+                                  std::memory_order_relaxed);
+}
+inline void set_log_off() {
+    detail::g_log_threshold.store(5, std::memory_order_relaxed);
+}
+inline log_level get_log_level() {
+    int level = detail::g_log_threshold.load(std::memory_order_relaxed);
+    return static_cast<log_level>(level > 4 ? 4 : level);
+}
+
+// 异步输出：启用后已通过级别检查的消息进入无锁队列，由后台线程写出
+inline void set_async_logging(bool enabled) {
+    auto &sink = detail::async_log_sink::instance();
+    if (enabled) {
+        sink.start();
+    } else {
+        sink.flush();
+        sink.stop();
+    }
+}
+inline bool async_logging() {
+    return detail::async_log_sink::instance().running();
+}
+inline void flush_log() { detail::async_log_sink::instance().flush(); }
+
 // ===========================================================================
 // 日志控制
 // ===========================================================================
@@ -101,23 +171,26 @@ inline void set_static_destruction() { in_static_destruction() = true; }
 // 统一的日志输出宏（支持 printf 风格格式化）
 // ===========================================================================
 
-// 基础日志宏
+// 基础日志宏：先做编译期级别裁剪（if constexpr 的丢弃分支只做类型检查），
+// 再做运行期级别检查，通过后才求值参数并格式化
 #define CHLOG(level, fmt, ...)                                                 \
     do {                                                                       \
-        if (ch::detail::in_static_destruction())                               \
-            break;                                                             \
-        auto loc = std::source_location::current();                            \
-        std::string msg = ch::detail::printf_format(fmt, ##__VA_ARGS__);       \
-        ch::detail::log_message(level, msg, loc);                              \
+        if constexpr (static_cast<int>(level) >= CH_LOG_MIN_LEVEL) {           \
+            if (ch::detail::log_enabled(level)) {                              \
+                const auto loc = std::source_location::current();             \
+                ch::detail::log_dispatch(level, &loc, fmt, ##__VA_ARGS__);     \
+            }                                                                  \
+        }                                                                      \
     } while (0)
 
 // 简洁日志宏（不显示位置信息）
 #define CHLOG_SIMPLE(level, fmt, ...)                                          \
     do {                                                                       \
-        if (ch::detail::in_static_destruction())                               \
-            break;                                                             \
-        std::string msg = ch::detail::printf_format(fmt, ##__VA_ARGS__);       \
-        ch::detail::log_message_simple(level, msg);                            \
+        if constexpr (static_cast<int>(level) >= CH_LOG_MIN_LEVEL) {           \
+            if (ch::detail::log_enabled(level)) {                              \
+                ch::detail::log_dispatch(level, nullptr, fmt, ##__VA_ARGS__);  \
+            }                                                                  \
+        }                                                                      \
     } while (0)
 
 // 便捷日志宏
@@ -139,7 +212,9 @@ inline void set_static_destruction() { in_static_destruction() = true; }
 // 带变量的日志宏（自动类型检测）
 #define CHDBG_VAR(var)                                                         \
     do {                                                                       \
-        if (!ch::detail::in_static_destruction()) {                            \
+        if constexpr (CH_LOG_MIN_LEVEL <= 0) {                                 \
+            if (!ch::detail::log_enabled(ch::log_level::debug))                \
+                break;                                                         \
             std::string var_value = ch::detail::to_string(var);                \
             std::string msg =                                                  \
                 ch::detail::printf_format("%s = %s", #var, var_value.c_str()); \
@@ -150,7 +225,9 @@ inline void set_static_destruction() { in_static_destruction() = true; }
 // 专门的指针变量输出宏
 #define CHDBG_PTR(ptr)                                                         \
     do {                                                                       \
-        if (!ch::detail::in_static_destruction()) {                            \
+        if constexpr (CH_LOG_MIN_LEVEL <= 0) {                                 \
+            if (!ch::detail::log_enabled(ch::log_level::debug))                \
+                break;                                                         \
             std::string msg = ch::detail::printf_format(                       \
                 "%s = 0x%llx", #ptr, (unsigned long long)(ptr));               \
             ch::detail::log_message_simple(ch::log_level::debug, msg);         \
@@ -162,7 +239,9 @@ inline void set_static_destruction() { in_static_destruction() = true; }
 #else
 #define CHDBG_FUNC()                                                           \
     do {                                                                       \
-        if (!ch::detail::in_static_destruction()) {                            \
+        if constexpr (CH_LOG_MIN_LEVEL <= 0) {                                 \
+            if (!ch::detail::log_enabled(ch::log_level::debug))                \
+                break;                                                         \
             auto loc = std::source_location::current();                        \
             std::string short_name =                                           \
                 ch::detail::short_function_name(loc.function_name());          \
@@ -251,6 +330,7 @@ inline void set_static_destruction() { in_static_destruction() = true; }
             std::string msg =                                                  \
                 ch::detail::printf_format("ABORT: " fmt, ##__VA_ARGS__);       \
             ch::detail::log_message(ch::log_level::fatal, msg, loc);           \
+            ch::flush_log();                                                   \
             std::abort();                                                      \
         }                                                                      \
     } while (false)
@@ -302,12 +382,18 @@ inline void log_message(log_level level, const std::string &message,
         return;
     }
 
+    auto &sink = async_log_sink::instance();
+    if (sink.running()) {
+        sink.push(level, &loc, "%s", message.c_str());
+        if (level == log_level::fatal) {
+            sink.flush();
+        }
+        return;
+    }
+
     // 根据日志级别决定输出流和是否输出
     switch (level) {
-    case log_level::debug:
-#ifndef CH_DEBUG
-        return; // 调试模式下才输出debug信息
-#endif
+    case log_level::debug: // 是否输出已由 CH_LOG_MIN_LEVEL / 运行期级别决定
     case log_level::info:
         std::cout << log_level_str(level) << " " << message << " at "
                   << loc.file_name() << ":" << loc.line() << std::endl;
@@ -337,12 +423,18 @@ inline void log_message_simple(log_level level, const std::string &message) {
     //     return;
     // }
 
+    auto &sink = async_log_sink::instance();
+    if (sink.running()) {
+        sink.push(level, nullptr, "%s", message.c_str());
+        if (level == log_level::fatal) {
+            sink.flush();
+        }
+        return;
+    }
+
     // 根据日志级别决定输出流和是否输出
     switch (level) {
-    case log_level::debug:
-#ifndef CH_DEBUG
-        return; // 调试模式下才输出debug信息
-#endif
+    case log_level::debug: // 是否输出已由 CH_LOG_MIN_LEVEL / 运行期级别决定
     case log_level::info:
         std::cout << log_level_str(level) << " " << message << std::endl;
         break;
@@ -361,6 +453,27 @@ inline void log_message_simple(log_level level, const std::string &message) {
     }
 }
 
+// CHLOG / CHLOG_SIMPLE 的出口：异步时直接 snprintf 进队列槽，
+// 同步时格式化后走原来的输出路径
+template <typename... Args>
+void log_dispatch(log_level level, const std::source_location *loc,
+                  const char *fmt, Args &&...args) {
+    auto &sink = async_log_sink::instance();
+    if (sink.running()) {
+        sink.push(level, loc, fmt, args...);
+        if (level == log_level::fatal) {
+            sink.flush();
+        }
+        return;
+    }
+    std::string msg = printf_format(fmt, args...);
+    if (loc) {
+        log_message(level, msg, *loc);
+    } else {
+        log_message_simple(level, msg);
+    }
+}
+
 } // namespace detail
 
 // ===========================================================================
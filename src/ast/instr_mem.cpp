@@ -24,10 +24,8 @@ instr_mem::instr_mem(uint32_t node_id, uint32_t addr_width, uint32_t data_width,
 
 void instr_mem::initialize_memory(const std::vector<sdata_type> &init_data) {
     // 1. 初始化内存数组为0
-    memory_.resize(depth_);
-    for (uint32_t i = 0; i < depth_; ++i) {
-        memory_[i] = sdata_type(0, data_width_); // 默认初始化为0
-    }
+    memory_ = std::make_shared<std::vector<sdata_type>>(
+        depth_, sdata_type(0, data_width_)); // 默认初始化为0
 
     // 2. 如果有初始数据，加载到内存中
     if (!init_data.empty()) {
@@ -37,7 +35,7 @@ void instr_mem::initialize_memory(const std::vector<sdata_type> &init_data) {
         for (uint32_t i = 0; i < load_count; ++i) {
             // 检查数据宽度是否匹配
             if (init_data[i].bitwidth() == data_width_) {
-                memory_[i] = init_data[i]; // 直接赋值，类型安全
+                (*memory_)[i] = init_data[i]; // 直接赋值，类型安全
             } else {
                 // 宽度不匹配时进行转换
                 CHERROR("Memory init data width mismatch at index %u: expected "
@@ -48,10 +46,18 @@ void instr_mem::initialize_memory(const std::vector<sdata_type> &init_data) {
     }
 
     CHDBG("Initialized %u memory locations with %s data",
-          static_cast<uint32_t>(memory_.size()),
+          static_cast<uint32_t>(memory_->size()),
           init_data.empty() ? "default (0)" : "custom");
 }
 
+std::vector<sdata_type> &instr_mem::writable_memory() {
+    // 只有 fork() 之后才会出现共享；第一次写入时复制一份私有存储
+    if (memory_.use_count() > 1) {
+        memory_ = std::make_shared<std::vector<sdata_type>>(*memory_);
+    }
+    return *memory_;
+}
+
 uint32_t instr_mem::get_address(const sdata_type &addr_data) const {
     uint64_t addr_val = static_cast<uint64_t>(addr_data);
     return static_cast<uint32_t>(addr_val) % depth_;
@@ -64,6 +70,7 @@ void instr_mem::write_memory(uint32_t addr, const sdata_type &data,
     if (enable.is_zero())
         return;
 
+    auto &memory = writable_memory();
     if (enable.bitwidth() > 1) {
         // 字节使能写入
         uint32_t bytes = (data_width_ + 7) / 8;
@@ -73,14 +80,14 @@ void instr_mem::write_memory(uint32_t addr, const sdata_type &data,
                      bit < 8 && (byte_idx * 8 + bit) < data_width_; ++bit) {
                     bool bit_val = data.get_bit(byte_idx * 8 +
                                                 bit); // 使用sdata_type的get_bit
-                    memory_[addr].set_bit(byte_idx * 8 + bit,
+                    memory[addr].set_bit(byte_idx * 8 + bit,
                                           bit_val); // 使用sdata_type的set_bit
                 }
             }
         }
     } else {
         // 全字写入
-        memory_[addr] = data;
+        memory[addr] = data;
         CHDBG("memory[%u] is written to %s", addr,
               data.to_string_verbose().c_str());
     }
@@ -92,8 +99,8 @@ sdata_type instr_mem::read_memory(uint32_t addr) const {
     }
 
     CHDBG("memory[%u] is read, the value is %s", addr,
-          memory_[addr].to_string_verbose().c_str());
-    return memory_[addr];
+          (*memory_)[addr].to_string_verbose().c_str());
+    return (*memory_)[addr];
 }
 
 void instr_mem::eval() {
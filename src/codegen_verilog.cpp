@@ -93,6 +93,11 @@ void verilogwriter::print(std::ostream &out) {
     }
 }
 
+std::string verilogwriter::node_name(ch::core::lnodeimpl *node) const {
+    auto it = node_names_.find(node);
+    return it != node_names_.end() ? it->second : std::string();
+}
+
 std::string verilogwriter::sanitize_name(const std::string &name) const {
     std::string sanitized = name;
     // Replace illegal characters with underscores
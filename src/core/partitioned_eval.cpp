@@ -0,0 +1,452 @@
+// src/core/partitioned_eval.cpp
+// ADR-037: 多线程分区求值 —— 簇划分、LPT 装箱与阶段屏障。
+#include "core/partitioned_eval.h"
+#include "ast/ast_nodes.h"
+#include "logger.h"
+
+#include <algorithm>
+#include <numeric>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace ch {
+
+namespace {
+
+using ch::core::lnodeimpl;
+using ch::core::lnodetype;
+
+// 工作线程进入 futex 等待前的自旋次数：tick 间隔通常只有几微秒，
+// 直接 wait 会让每个阶段都付出一次唤醒延迟
+constexpr int kSpinIterations = 4096;
+
+inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#else
+    std::this_thread::yield();
+#endif
+}
+
+// 估算单条指令的代价：按 64 位字数计，运算节点额外加权
+uint64_t estimate_cost(const lnodeimpl *node) {
+    uint64_t words = (node->size() + 63) / 64;
+    if (words == 0)
+        words = 1;
+    switch (node->type()) {
+    case lnodetype::type_op:
+        return 2 + 2 * words;
+    case lnodetype::type_mux:
+        return 2 + words;
+    case lnodetype::type_mem:
+        // 存储体节点本身不在每拍搬运数据，size() 是整块存储的位数
+        return 1;
+    default:
+        return 1 + words;
+    }
+}
+
+struct UnionFind {
+    std::vector<uint32_t> parent;
+
+    explicit UnionFind(size_t n) : parent(n) {
+        std::iota(parent.begin(), parent.end(), 0u);
+    }
+
+    uint32_t find(uint32_t x) {
+        while (parent[x] != x) {
+            parent[x] = parent[parent[x]];
+            x = parent[x];
+        }
+        return x;
+    }
+
+    void unite(uint32_t a, uint32_t b) {
+        a = find(a);
+        b = find(b);
+        if (a != b)
+            parent[std::max(a, b)] = std::min(a, b);
+    }
+};
+
+} // namespace
+
+PartitionedEvaluator::PartitionedEvaluator(unsigned threads)
+    : threads_(std::max(1u, threads)) {
+    partitions_.resize(threads_);
+    stats_.threads = threads_;
+    workers_.reserve(threads_ - 1);
+    for (size_t i = 1; i < threads_; ++i) {
+        workers_.emplace_back([this, i] { worker_main(i); });
+    }
+}
+
+PartitionedEvaluator::~PartitionedEvaluator() {
+    if (workers_.empty())
+        return;
+    phase_ = Phase::Stop;
+    generation_.fetch_add(1, std::memory_order_release);
+    generation_.notify_all();
+    for (auto &worker : workers_) {
+        worker.join();
+    }
+}
+
+void PartitionedEvaluator::build(
+    const std::vector<ch::core::lnodeimpl *> &eval_list,
+    const instr_list &combinational, const instr_list &sequential) {
+    CHDBG_FUNC();
+
+    for (auto &partition : partitions_) {
+        partition = Partition{};
+    }
+    serial_seq_.clear();
+    has_boundary_ = false;
+    stats_ = PartitionStats{};
+    stats_.threads = threads_;
+
+    std::unordered_map<uint32_t, lnodeimpl *> nodes;
+    nodes.reserve(eval_list.size());
+    for (auto *node : eval_list) {
+        if (node)
+            nodes[node->id()] = node;
+    }
+
+    // 组合节点编号：下标即 combinational 中的位置（保持拓扑序）
+    const uint32_t num_comb = static_cast<uint32_t>(combinational.size());
+    std::unordered_map<uint32_t, uint32_t> comb_index;
+    comb_index.reserve(num_comb);
+    for (uint32_t i = 0; i < num_comb; ++i) {
+        comb_index[combinational[i].first] = i;
+    }
+    std::unordered_set<uint32_t> seq_ids;
+    for (const auto &[id, instr] : sequential) {
+        seq_ids.insert(id);
+    }
+
+    // 每个组合节点的组合前驱（寄存器、输入、字面量等在组合阶段只读，不计入）
+    std::vector<lnodeimpl *> comb_node(num_comb, nullptr);
+    std::vector<std::vector<uint32_t>> comb_srcs(num_comb);
+    std::vector<std::vector<uint32_t>> comb_users(num_comb);
+    std::vector<uint64_t> node_cost(num_comb, 1);
+    for (uint32_t i = 0; i < num_comb; ++i) {
+        auto node_it = nodes.find(combinational[i].first);
+        if (node_it == nodes.end())
+            continue;
+        comb_node[i] = node_it->second;
+        node_cost[i] = estimate_cost(node_it->second);
+        for (auto *src : node_it->second->srcs()) {
+            if (!src)
+                continue;
+            auto src_it = comb_index.find(src->id());
+            if (src_it != comb_index.end()) {
+                comb_srcs[i].push_back(src_it->second);
+                comb_users[src_it->second].push_back(i);
+            }
+        }
+    }
+
+    // 1. 边界节点：没有组合前驱的节点（寄存器的 proxy 副本、常量运算等），
+    //    只依赖本阶段只读的值。若它们被多个簇读取（例如被多处引用的寄存器），
+    //    就放进边界子阶段单独求值，不让它们把所有读取者连成一个大簇
+    std::vector<bool> level0(num_comb, false);
+    for (uint32_t i = 0; i < num_comb; ++i) {
+        level0[i] = comb_srcs[i].empty();
+    }
+
+    UnionFind uf(num_comb);
+    for (uint32_t i = 0; i < num_comb; ++i) {
+        if (level0[i])
+            continue;
+        for (uint32_t src : comb_srcs[i]) {
+            if (!level0[src])
+                uf.unite(i, src);
+        }
+    }
+
+    std::vector<bool> shared(num_comb, false);
+    for (uint32_t i = 0; i < num_comb; ++i) {
+        if (!level0[i])
+            continue;
+        uint32_t first_root = static_cast<uint32_t>(-1);
+        for (uint32_t user : comb_users[i]) {
+            uint32_t root = uf.find(user);
+            if (first_root == static_cast<uint32_t>(-1)) {
+                first_root = root;
+            } else if (root != first_root) {
+                shared[i] = true;
+                break;
+            }
+        }
+        if (!shared[i] && first_root != static_cast<uint32_t>(-1))
+            uf.unite(i, first_root);
+    }
+
+    constexpr uint32_t kNone = static_cast<uint32_t>(-1);
+    std::unordered_map<uint32_t, uint32_t> cluster_of_root;
+    std::vector<uint32_t> cluster_of(num_comb, kNone);
+    std::vector<uint64_t> cluster_cost;
+    for (uint32_t i = 0; i < num_comb; ++i) {
+        if (shared[i])
+            continue;
+        uint32_t root = uf.find(i);
+        auto [it, inserted] = cluster_of_root.try_emplace(
+            root, static_cast<uint32_t>(cluster_cost.size()));
+        if (inserted)
+            cluster_cost.push_back(0);
+        cluster_of[i] = it->second;
+        cluster_cost[it->second] += node_cost[i];
+    }
+    const size_t num_clusters = cluster_cost.size();
+
+    // 2. 寄存器的"归属簇"= 其 next 所在的簇；簇经由边界节点或直接读取的
+    //    寄存器用于装箱时的亲和度
+    std::unordered_map<uint32_t, uint32_t> home_cluster_of_reg;
+    for (const auto &[id, instr] : sequential) {
+        auto node_it = nodes.find(id);
+        if (node_it == nodes.end() ||
+            node_it->second->type() != lnodetype::type_reg)
+            continue;
+        auto *next = static_cast<ch::core::regimpl *>(node_it->second)
+                         ->get_next();
+        if (!next)
+            continue;
+        auto next_it = comb_index.find(next->id());
+        if (next_it != comb_index.end() &&
+            cluster_of[next_it->second] != kNone)
+            home_cluster_of_reg[id] = cluster_of[next_it->second];
+    }
+
+    auto regs_read_by = [&](uint32_t i, std::vector<uint32_t> &out) {
+        for (auto *src : comb_node[i]->srcs()) {
+            if (src && src->type() == lnodetype::type_reg)
+                out.push_back(src->id());
+        }
+    };
+    std::vector<std::vector<uint32_t>> cluster_reads(num_clusters);
+    for (uint32_t i = 0; i < num_comb; ++i) {
+        if (!comb_node[i] || shared[i])
+            continue;
+        auto &reads = cluster_reads[cluster_of[i]];
+        regs_read_by(i, reads);
+        for (uint32_t src : comb_srcs[i]) {
+            if (shared[src] && comb_node[src])
+                regs_read_by(src, reads);
+        }
+    }
+
+    // 3. LPT 装箱：按代价降序，放入负载最小的分区；若亲和度最高的分区
+    //    放入后不超过上限，则优先选它（减少跨分区寄存器边）
+    uint64_t total = std::accumulate(cluster_cost.begin(), cluster_cost.end(),
+                                     uint64_t{0});
+    uint64_t largest =
+        num_clusters
+            ? *std::max_element(cluster_cost.begin(), cluster_cost.end())
+            : 0;
+    uint64_t cap = std::max<uint64_t>(
+        largest, (total * 105 / 100 + threads_ - 1) / threads_);
+
+    std::vector<uint32_t> order(num_clusters);
+    std::iota(order.begin(), order.end(), 0u);
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+        return cluster_cost[a] > cluster_cost[b];
+    });
+
+    std::vector<uint32_t> partition_of_cluster(num_clusters, kNone);
+    std::vector<uint64_t> load(threads_, 0);
+    std::vector<uint32_t> affinity(threads_, 0);
+    for (uint32_t cluster : order) {
+        std::fill(affinity.begin(), affinity.end(), 0);
+        for (uint32_t reg_id : cluster_reads[cluster]) {
+            auto home_it = home_cluster_of_reg.find(reg_id);
+            if (home_it == home_cluster_of_reg.end())
+                continue;
+            uint32_t p = partition_of_cluster[home_it->second];
+            if (p != kNone)
+                ++affinity[p];
+        }
+
+        size_t best = std::min_element(load.begin(), load.end()) - load.begin();
+        size_t preferred = std::max_element(affinity.begin(), affinity.end()) -
+                           affinity.begin();
+        if (affinity[preferred] > 0 &&
+            load[preferred] + cluster_cost[cluster] <= cap) {
+            best = preferred;
+        }
+        partition_of_cluster[cluster] = static_cast<uint32_t>(best);
+        load[best] += cluster_cost[cluster];
+    }
+
+    // 4. 时序节点：寄存器跟随归属簇；读取其他时序节点输出的寄存器与存储器
+    //    端口（共享存储体）在主线程串行执行，保持原有的求值顺序语义
+    constexpr uint32_t kSerial = static_cast<uint32_t>(-2);
+    auto written_in_seq = [&](const lnodeimpl *node) {
+        return node && seq_ids.count(node->id()) != 0;
+    };
+    std::unordered_map<uint32_t, uint32_t> partition_of_seq;
+    for (const auto &[id, instr] : sequential) {
+        auto node_it = nodes.find(id);
+        auto *node = node_it != nodes.end() ? node_it->second : nullptr;
+        if (!node || node->type() != lnodetype::type_reg) {
+            serial_seq_.push_back(instr);
+            partition_of_seq[id] = kSerial;
+            continue;
+        }
+        auto *reg = static_cast<ch::core::regimpl *>(node);
+        if (written_in_seq(reg->get_next()) || written_in_seq(reg->rst()) ||
+            written_in_seq(reg->clk_en()) || written_in_seq(reg->rst_val())) {
+            serial_seq_.push_back(instr);
+            partition_of_seq[id] = kSerial;
+            continue;
+        }
+
+        size_t target;
+        auto home_it = home_cluster_of_reg.find(id);
+        if (home_it != home_cluster_of_reg.end()) {
+            target = partition_of_cluster[home_it->second];
+        } else {
+            target = std::min_element(load.begin(), load.end()) - load.begin();
+        }
+        partitions_[target].seq.push_back(instr);
+        load[target] += 1;
+        partition_of_seq[id] = static_cast<uint32_t>(target);
+    }
+
+    // 5. 按拓扑序把组合节点放进各分区；共享边界节点放到它读取的寄存器
+    //    所在分区（没有时放到边界负载最小的分区）
+    std::vector<uint32_t> partition_of_comb(num_comb, kNone);
+    std::vector<uint64_t> boundary_load(threads_, 0);
+    for (uint32_t i = 0; i < num_comb; ++i) {
+        uint32_t p;
+        if (shared[i]) {
+            p = kNone;
+            if (comb_node[i]) {
+                for (auto *src : comb_node[i]->srcs()) {
+                    auto it = src ? partition_of_seq.find(src->id())
+                                  : partition_of_seq.end();
+                    if (it != partition_of_seq.end() && it->second != kSerial) {
+                        p = it->second;
+                        break;
+                    }
+                }
+            }
+            if (p == kNone) {
+                p = static_cast<uint32_t>(
+                    std::min_element(boundary_load.begin(),
+                                     boundary_load.end()) -
+                    boundary_load.begin());
+            }
+            boundary_load[p] += node_cost[i];
+            partitions_[p].boundary.push_back(combinational[i].second);
+            has_boundary_ = true;
+        } else {
+            p = partition_of_cluster[cluster_of[i]];
+            partitions_[p].comb.push_back(combinational[i].second);
+        }
+        partitions_[p].cost += node_cost[i];
+        partition_of_comb[i] = p;
+    }
+    for (size_t p = 0; p < threads_; ++p) {
+        partitions_[p].cost += partitions_[p].seq.size();
+    }
+
+    // 6. 统计：跨分区的边 = 读取者与被读的组合节点/寄存器不在同一分区
+    stats_.clusters = num_clusters;
+    stats_.comb_nodes = num_comb;
+    stats_.serial_nodes = serial_seq_.size();
+    stats_.max_cluster_cost = largest;
+    for (const auto &partition : partitions_) {
+        stats_.seq_nodes += partition.seq.size();
+        stats_.boundary_nodes += partition.boundary.size();
+        stats_.total_cost += partition.cost;
+        stats_.max_partition_cost =
+            std::max(stats_.max_partition_cost, partition.cost);
+    }
+    for (uint32_t i = 0; i < num_comb; ++i) {
+        if (!comb_node[i])
+            continue;
+        for (uint32_t src : comb_srcs[i]) {
+            if (partition_of_comb[src] != partition_of_comb[i])
+                ++stats_.cut_edges;
+        }
+        for (auto *src : comb_node[i]->srcs()) {
+            if (!src || src->type() != lnodetype::type_reg)
+                continue;
+            auto it = partition_of_seq.find(src->id());
+            if (it == partition_of_seq.end() ||
+                it->second != partition_of_comb[i])
+                ++stats_.cut_edges;
+        }
+    }
+
+    CHINFO("Partitioned %zu comb / %zu seq nodes into %u partitions: "
+           "%zu clusters, %zu boundary nodes, balance %.2f, %zu cut edges, "
+           "%zu serial",
+           stats_.comb_nodes, stats_.seq_nodes, threads_, stats_.clusters,
+           stats_.boundary_nodes, stats_.balance(), stats_.cut_edges,
+           stats_.serial_nodes);
+}
+
+void PartitionedEvaluator::run_partition(size_t index, Phase phase) {
+    const auto &partition = partitions_[index];
+    const auto &list = phase == Phase::Boundary ? partition.boundary
+                       : phase == Phase::Comb   ? partition.comb
+                                                : partition.seq;
+    for (auto *instr : list) {
+        instr->eval();
+    }
+}
+
+void PartitionedEvaluator::run_phase(Phase phase) {
+    if (workers_.empty()) {
+        run_partition(0, phase);
+        return;
+    }
+
+    phase_ = phase;
+    pending_.store(static_cast<uint32_t>(workers_.size()),
+                   std::memory_order_relaxed);
+    generation_.fetch_add(1, std::memory_order_release);
+    generation_.notify_all();
+
+    run_partition(0, phase);
+
+    // 阶段屏障：先自旋，工作线程未完成再进入 futex 等待
+    uint32_t remaining = pending_.load(std::memory_order_acquire);
+    for (int spin = 0; remaining != 0 && spin < kSpinIterations; ++spin) {
+        cpu_relax();
+        remaining = pending_.load(std::memory_order_acquire);
+    }
+    while (remaining != 0) {
+        pending_.wait(remaining, std::memory_order_acquire);
+        remaining = pending_.load(std::memory_order_acquire);
+    }
+}
+
+void PartitionedEvaluator::worker_main(size_t index) {
+    uint32_t seen = 0;
+    for (;;) {
+        uint32_t current = generation_.load(std::memory_order_acquire);
+        for (int spin = 0; current == seen && spin < kSpinIterations;
+             ++spin) {
+            cpu_relax();
+            current = generation_.load(std::memory_order_acquire);
+        }
+        while (current == seen) {
+            generation_.wait(seen, std::memory_order_acquire);
+            current = generation_.load(std::memory_order_acquire);
+        }
+        seen = current;
+
+        if (phase_ == Phase::Stop)
+            return;
+
+        run_partition(index, phase_);
+
+        if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            pending_.notify_one();
+        }
+    }
+}
+
+} // namespace ch
@@ -1,22 +1,25 @@
 // src/core/verilator_backend.cpp
 // ADR-035 / Phase 3.1-3.5: VerilatorBackend implementation.
 //
-// STATUS (2026-06-07): scaffolding. The full dlopen + ISignalAccess
-// port mapping requires generating a C++ wrapper that knows the
-// Vtop field layout, which is generated by Verilator at compile
-// time. This implementation generates the Verilog, invokes
-// `verilator --cc --build` to produce a .a archive, and computes
-// the SHA-1 cache key. The dlopen + port-binding step is left as
-// a stub (Phase 3.2 follow-up).
+// initialize() writes top.v plus a per-design cpphdl_wrapper.cpp,
+// builds both into obj_dir/libVtop.so with `verilator --cc --exe
+// --build -CFLAGS -fPIC -LDFLAGS -shared`, caches the library under a
+// SHA-1 of (Verilog + wrapper + `verilator --version`), dlopen's it and
+// binds every port's field_ptr through the wrapper's
+// cpphdl_bind_ports(). Without a usable verilator the backend keeps the
+// port metadata and evaluates through the interpreter lists instead.
 #include "core/verilator_backend.h"
 #include "codegen_verilog.h"
 #include "logger.h"
 
+#include <algorithm>
 #include <array>
+#include <cctype>
 #include <cstdint>
 #include <cstdio>
 #include <cstdlib>
 #include <dlfcn.h>
+#include <filesystem>
 #include <fstream>
 #include <iomanip>
 #include <sstream>
@@ -128,12 +131,80 @@ bool path_exists(const std::string &p) {
     return stat(p.c_str(), &st) == 0;
 }
 
+std::string read_file(const std::string &path) {
+    std::ifstream in(path);
+    return std::string((std::istreambuf_iterator<char>(in)),
+                       std::istreambuf_iterator<char>());
+}
+
+// Verilator 会对含 "__"、以 '_' 开头或结尾的标识符做转义（__05F），
+// wrapper 里的 &top-><name> 只对未转义的名字成立
+bool is_plain_verilator_name(const std::string &name) {
+    if (name.empty() || !std::isalpha(static_cast<unsigned char>(name[0])) ||
+        name.back() == '_' || name.find("__") != std::string::npos) {
+        return false;
+    }
+    return std::all_of(name.begin(), name.end(), [](char c) {
+        return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+    });
+}
+
+// CData/SData/IData/QData 按位宽取整存放；> 64 位为 VlWide 的 32 位字
+void store_port(void *field, uint32_t width, const ch::core::sdata_type &v) {
+    const uint64_t *w = v.bitvector().words();
+    if (width <= 8) {
+        *static_cast<uint8_t *>(field) = static_cast<uint8_t>(w[0]);
+    } else if (width <= 16) {
+        *static_cast<uint16_t *>(field) = static_cast<uint16_t>(w[0]);
+    } else if (width <= 32) {
+        *static_cast<uint32_t *>(field) = static_cast<uint32_t>(w[0]);
+    } else if (width <= 64) {
+        *static_cast<uint64_t *>(field) = w[0];
+    } else {
+        auto *dst = static_cast<uint32_t *>(field);
+        for (uint32_t i = 0; i < (width + 31) / 32; ++i) {
+            dst[i] = static_cast<uint32_t>(w[i / 2] >> (32 * (i % 2)));
+        }
+    }
+}
+
+void load_port(const void *field, uint32_t width, ch::core::sdata_type &v) {
+    uint64_t *w = v.bitvector().words();
+    if (width <= 64) {
+        uint64_t value;
+        if (width <= 8) {
+            value = *static_cast<const uint8_t *>(field);
+        } else if (width <= 16) {
+            value = *static_cast<const uint16_t *>(field);
+        } else if (width <= 32) {
+            value = *static_cast<const uint32_t *>(field);
+        } else {
+            value = *static_cast<const uint64_t *>(field);
+        }
+        w[0] = width < 64 ? value & ((uint64_t(1) << width) - 1) : value;
+        return;
+    }
+    const auto *src = static_cast<const uint32_t *>(field);
+    const uint32_t n32 = (width + 31) / 32;
+    for (uint32_t i = 0; i < (width + 63) / 64; ++i) {
+        uint64_t lo = src[2 * i];
+        uint64_t hi = (2 * i + 1 < n32) ? src[2 * i + 1] : 0;
+        w[i] = lo | (hi << 32);
+    }
+    if (width % 64) {
+        w[(width - 1) / 64] &= (uint64_t(1) << (width % 64)) - 1;
+    }
+}
+
 } // namespace
 
+
 namespace ch {
 
-VerilatorBackend::VerilatorBackend(std::string verilog_path)
-    : verilator_work_dir_(std::move(verilog_path)) {}
+VerilatorBackend::VerilatorBackend(std::string verilog_path,
+                                   std::string verilator_bin)
+    : verilator_work_dir_(std::move(verilog_path)),
+      verilator_bin_(std::move(verilator_bin)) {}
 
 VerilatorBackend::~VerilatorBackend() {
     clear();
@@ -141,284 +212,349 @@ VerilatorBackend::~VerilatorBackend() {
 
 bool VerilatorBackend::initialize(ch::core::context *ctx,
                                   ch::data_map_t &data_map) {
+    close_top();
     ctx_ = ctx;
     data_map_ = &data_map;
+    compiled_so_path_.clear();
 
-    if (!generate_verilog(ctx)) {
+    if (!generate_verilog(ctx) || !generate_wrapper()) {
         CHERROR("VerilatorBackend: failed to generate Verilog");
         return false;
     }
 
-    // Verilator compilation is best-effort in the scaffolding. If it
-    // fails (missing tool, slow build, etc.), we log a warning and
-    // continue — the architecture is validated even without a working
-    // .so. The full dlopen path is Phase 3.2.
-    // Phase 3.5: SHA-1 cache hit. Read back the generated Verilog,
-    // compute the cache key, and skip invoke_verilator if a cached
-    // Vtop binary already exists on disk.
-    {
-        std::ifstream vfile(verilator_work_dir_ + "/top.v");
-        std::string vsource((std::istreambuf_iterator<char>(vfile)),
-                            std::istreambuf_iterator<char>());
-        if (vfile && !vsource.empty()) {
-            std::string key = compute_cache_key(vsource, "5.020");
-            std::string cached = cache_path_for_key(key);
-            if (!cached.empty() && path_exists(cached)) {
-                compiled_so_path_ = cached;
-                CHINFO("VerilatorBackend: cache hit at %s", cached.c_str());
-            } else {
-                if (!invoke_verilator(verilator_work_dir_ + "/top.v")) {
-                    CHWARN("VerilatorBackend: verilator compilation failed "
-                           "(continuing without .so — dlopen is a stub)");
+    // 模型不可用（没有 verilator、编译失败、名字需要转义）时 initialize
+    // 仍然成功：端口元数据照常建立，eval_* 退回解释器指令列表。
+    verilator_version_ = detect_verilator_version(verilator_bin_);
+    bool bindable = std::all_of(
+        wrapper_ports_.begin(), wrapper_ports_.end(),
+        [](const WrapperPort &p) { return is_plain_verilator_name(p.name); });
+    if (verilator_version_.empty()) {
+        CHWARN("VerilatorBackend: '%s --version' failed, evaluating "
+               "through the interpreter", verilator_bin_.c_str());
+    } else if (!bindable) {
+        CHWARN("VerilatorBackend: port names need Verilator escaping, "
+               "evaluating through the interpreter");
+    } else {
+        // Phase 3.5: SHA-1 cache keyed on the Verilog, the wrapper and
+        // the detected verilator version (generated code is not
+        // ABI-stable across versions, ADR-035 R1).
+        const std::string key = compute_cache_key(
+            read_file(verilator_work_dir_ + "/top.v") +
+                read_file(verilator_work_dir_ + "/cpphdl_wrapper.cpp"),
+            verilator_version_);
+        const std::string cached = cached_library_path(key);
+        if (!cached.empty() && path_exists(cached)) {
+            compiled_so_path_ = cached;
+            CHINFO("VerilatorBackend: cache hit at %s", cached.c_str());
+        } else if (invoke_verilator(verilator_work_dir_ + "/top.v")) {
+            compiled_so_path_ = verilator_work_dir_ + "/obj_dir/libVtop.so";
+            if (!cached.empty()) {
+                std::error_code ec;
+                std::filesystem::create_directories(
+                    std::filesystem::path(cached).parent_path(), ec);
+                std::filesystem::copy_file(
+                    compiled_so_path_, cached,
+                    std::filesystem::copy_options::overwrite_existing, ec);
+                if (!ec) {
+                    compiled_so_path_ = cached;
                 }
             }
+        } else {
+            CHWARN("VerilatorBackend: verilator compilation failed, "
+                   "evaluating through the interpreter");
         }
     }
 
-    if (!dlopen_top(compiled_so_path_)) {
+    if (!compiled_so_path_.empty() && !dlopen_top(compiled_so_path_)) {
         CHWARN("VerilatorBackend: dlopen of %s failed",
                compiled_so_path_.c_str());
     }
 
     build_port_access_table();
-
+    if (top_instance_) {
+        // 初始组合求值，让输出在第一拍之前就有效
+        sync_inputs_to_vtop();
+        eval_fn_(top_instance_);
+        sync_outputs_from_vtop();
+    }
     return true;
 }
 
 void VerilatorBackend::clear() {
     close_top();
     port_access_.clear();
+    wrapper_ports_.clear();
+    bound_inputs_.clear();
+    bound_outputs_.clear();
     ctx_ = nullptr;
     data_map_ = nullptr;
 }
 
 bool VerilatorBackend::generate_verilog(ch::core::context *ctx) {
-    {
-        std::ofstream out(verilator_work_dir_ + "/top.v");
-        if (!out.is_open()) {
-            CHERROR("Cannot open %s/top.v for writing",
-                    verilator_work_dir_.c_str());
-            return false;
+    std::ofstream out(verilator_work_dir_ + "/top.v");
+    if (!out.is_open()) {
+        CHERROR("Cannot open %s/top.v for writing",
+                verilator_work_dir_.c_str());
+        return false;
+    }
+    verilogwriter writer(ctx);
+    writer.print(out);
+    out.close();
+    CHINFO("VerilatorBackend: wrote %s/top.v", verilator_work_dir_.c_str());
+
+    // wrapper 的端口顺序：时钟、复位、输入、输出（与 print_header 一致）
+    wrapper_ports_.clear();
+    using ch::core::lnodetype;
+    for (lnodetype type : {lnodetype::type_clock, lnodetype::type_reset,
+                           lnodetype::type_input, lnodetype::type_output}) {
+        for (auto *node : ctx->get_eval_list()) {
+            if (node && node->type() == type) {
+                wrapper_ports_.push_back({node, writer.node_name(node)});
+            }
         }
-        verilogwriter writer(ctx);
-        writer.print(out);
-        out.close();
-        CHINFO("VerilatorBackend: wrote %s/top.v",
-               verilator_work_dir_.c_str());
-    }
-    // Generate a sim_main.cpp with main() and extern "C" factory/
-    // eval/final/delete functions. This lets us use --cc --exe to
-    // produce a single binary that links the generated Vtop + a
-    // host that we dlopen. The wrapper is identical for every
-    // design (the Vtop class is the only thing that varies).
-    {
-        std::ofstream out(verilator_work_dir_ + "/sim_main.cpp");
-        if (!out.is_open()) {
-            CHERROR("Cannot open %s/sim_main.cpp for writing",
-                    verilator_work_dir_.c_str());
-            return false;
+    }
+    return true;
+}
+
+bool VerilatorBackend::generate_wrapper() {
+    // Replaces the Phase 3.2a sim_main.cpp: no main(), the objects are
+    // linked with -shared so the result can be dlopen'd. Port order is
+    // the wrapper_ports_ order; cpphdl_port_count() guards against a
+    // library built for a different port list.
+    std::ofstream out(verilator_work_dir_ + "/cpphdl_wrapper.cpp");
+    if (!out.is_open()) {
+        CHERROR("Cannot open %s/cpphdl_wrapper.cpp for writing",
+                verilator_work_dir_.c_str());
+        return false;
+    }
+    out << "// Generated by VerilatorBackend (ADR-035 Phase 3.3).\n"
+           "#include \"Vtop.h\"\n"
+           "#include \"verilated.h\"\n"
+           "#include <cstdint>\n"
+           "\n"
+           "extern \"C\" {\n"
+           "void* new_Vtop() {\n"
+           "    auto* ctx = new VerilatedContext;\n"
+           "    static const char* argv0 = \"cpphdl\";\n"
+           "    ctx->commandArgs(1, &argv0);\n"
+           "    return new Vtop{ctx, \"TOP\"};\n"
+           "}\n"
+           "void eval_Vtop(void* top) {\n"
+           "    static_cast<Vtop*>(top)->eval();\n"
+           "}\n"
+           "void final_Vtop(void* top) {\n"
+           "    static_cast<Vtop*>(top)->final();\n"
+           "}\n"
+           "void delete_Vtop(void* top) {\n"
+           "    auto* vtop = static_cast<Vtop*>(top);\n"
+           "    auto* ctx = vtop->contextp();\n"
+           "    delete vtop;\n"
+           "    delete ctx;\n"
+           "}\n"
+           "uint32_t cpphdl_port_count() { return "
+        << wrapper_ports_.size()
+        << "u; }\n"
+           "void cpphdl_bind_ports(void* top, void** fields) {\n"
+           "    auto* t = static_cast<Vtop*>(top);\n";
+    for (size_t i = 0; i < wrapper_ports_.size(); ++i) {
+        if (is_plain_verilator_name(wrapper_ports_[i].name)) {
+            out << "    fields[" << i << "] = static_cast<void*>(&t->"
+                << wrapper_ports_[i].name << ");\n";
+        } else {
+            out << "    fields[" << i << "] = nullptr;\n";
         }
-        out <<
-            "// Generated by VerilatorBackend (ADR-035 Phase 3.2a).\n"
-            "// Provides main() for verilator --cc --exe --build AND\n"
-            "// extern \"C\" factory/eval/final/delete for dlopen.\n"
-            "#include \"Vtop.h\"\n"
-            "#include \"verilated.h\"\n"
-            "#include <cstdio>\n"
-            "\n"
-            "extern \"C\" {\n"
-            "void* new_Vtop() {\n"
-            "    auto* ctx = new VerilatedContext;\n"
-            "    static const char* argv0 = \"cpphdl\";\n"
-            "    ctx->commandArgs(1, &argv0);\n"
-            "    return new Vtop{ctx, \"TOP\"};\n"
-            "}\n"
-            "void eval_Vtop(void* top) {\n"
-            "    static_cast<Vtop*>(top)->eval();\n"
-            "}\n"
-            "void final_Vtop(void* top) {\n"
-            "    static_cast<Vtop*>(top)->final();\n"
-            "}\n"
-            "void delete_Vtop(void* top) {\n"
-            "    auto* vtop = static_cast<Vtop*>(top);\n"
-            "    auto* ctx = vtop->contextp();\n"
-            "    delete vtop;\n"
-            "    delete ctx;\n"
-            "}\n"
-            "}\n"
-            "\n"
-            "int main(int argc, char** argv) {\n"
-            "    (void)argc; (void)argv;\n"
-            "    auto* top = static_cast<Vtop*>(new_Vtop());\n"
-            "    top->eval();\n"
-            "    final_Vtop(top);\n"
-            "    delete_Vtop(top);\n"
-            "    return 0;\n"
-            "}\n";
-        out.close();
-        CHINFO("VerilatorBackend: wrote %s/sim_main.cpp",
-               verilator_work_dir_.c_str());
     }
+    if (wrapper_ports_.empty()) {
+        out << "    (void)t; (void)fields;\n";
+    }
+    out << "}\n"
+           "}\n";
+    CHINFO("VerilatorBackend: wrote %s/cpphdl_wrapper.cpp",
+           verilator_work_dir_.c_str());
     return true;
 }
 
 bool VerilatorBackend::invoke_verilator(const std::string & /*verilog_path*/) {
-    // ADR-035 / Phase 3.2a: use --cc --exe --build so verilator
-    // compiles both top.v and the generated sim_main.cpp (which has
-    // main() + extern "C" factory/eval/final/delete for dlopen)
-    // into a single binary at obj_dir/Vtop.
-    const std::string cmd = "cd " + verilator_work_dir_ +
-                            " && verilator --cc --exe --build "
-                            "-j 0 -Wno-WIDTH -Wno-UNOPTFLAT "
-                            "top.v sim_main.cpp 2>&1";
-    return run_shell(cmd);
+    // --exe 让 verilator 把 wrapper 一起编译链接；-LDFLAGS -shared 把
+    // 最终产物变成可 dlopen 的 obj_dir/libVtop.so（-CFLAGS 同样作用于
+    // verilated.cpp 等运行时对象，因此全部是 -fPIC）
+    const std::string cmd = "cd " + verilator_work_dir_ + " && " +
+                            verilator_bin_ +
+                            " --cc --exe --build -j 0 -Wno-WIDTH "
+                            "-Wno-UNOPTFLAT -CFLAGS -fPIC -LDFLAGS -shared "
+                            "-o libVtop.so top.v cpphdl_wrapper.cpp 2>&1";
+    return run_shell(cmd) &&
+           path_exists(verilator_work_dir_ + "/obj_dir/libVtop.so");
 }
 
 bool VerilatorBackend::dlopen_top(const std::string &so_path) {
-    // ADR-035 / Phase 3.2b: dlopen the compiled binary and resolve
-    // the extern "C" symbols produced by sim_main.cpp. For now we
-    // load the static executable at obj_dir/Vtop (not a shared
-    // library); RTLD_LAZY is sufficient because we resolve every
-    // symbol immediately after dlopen. A future build-flag switch
-    // to --shared -fPIC will let us dlopen libVtop.so directly.
+    // ADR-035 / Phase 3.2b: dlopen the shared library and resolve the
+    // extern "C" symbols of cpphdl_wrapper.cpp. RTLD_LOCAL keeps the
+    // Verilated runtime of different designs apart.
     if (so_path.empty() || !path_exists(so_path)) {
         return false;
     }
-    dl_handle_ = dlopen(so_path.c_str(), RTLD_LAZY | RTLD_LOCAL);
+    dl_handle_ = dlopen(so_path.c_str(), RTLD_NOW | RTLD_LOCAL);
     if (!dl_handle_) {
         CHWARN("dlopen failed: %s", dlerror());
         return false;
     }
-    using FactoryFn = void *(*)();
-    using EvalFn = void (*)(void *);
-    using FinalFn = void (*)(void *);
-    using DeleteFn = void (*)(void *);
-    auto *factory = reinterpret_cast<FactoryFn>(
-        dlsym(dl_handle_, "new_Vtop"));
-    eval_fn_ = reinterpret_cast<EvalFn>(
+    new_fn_ = reinterpret_cast<void *(*)()>(dlsym(dl_handle_, "new_Vtop"));
+    eval_fn_ = reinterpret_cast<void (*)(void *)>(
         dlsym(dl_handle_, "eval_Vtop"));
-    final_fn_ = reinterpret_cast<FinalFn>(
+    final_fn_ = reinterpret_cast<void (*)(void *)>(
         dlsym(dl_handle_, "final_Vtop"));
-    auto *deleter = reinterpret_cast<DeleteFn>(
+    delete_fn_ = reinterpret_cast<void (*)(void *)>(
         dlsym(dl_handle_, "delete_Vtop"));
-    if (!factory || !eval_fn_ || !final_fn_ || !deleter) {
-        CHWARN("dlsym missing symbol: factory=%p eval=%p final=%p "
-               "delete=%p", (void *)factory, (void *)(void *)eval_fn_,
-               (void *)final_fn_, (void *)deleter);
-        dlclose(dl_handle_);
-        dl_handle_ = nullptr;
+    port_count_fn_ = reinterpret_cast<uint32_t (*)()>(
+        dlsym(dl_handle_, "cpphdl_port_count"));
+    bind_ports_fn_ = reinterpret_cast<void (*)(void *, void **)>(
+        dlsym(dl_handle_, "cpphdl_bind_ports"));
+    if (!new_fn_ || !eval_fn_ || !final_fn_ || !delete_fn_ ||
+        !port_count_fn_ || !bind_ports_fn_) {
+        CHWARN("dlsym missing symbol in %s", so_path.c_str());
+        close_top();
+        return false;
+    }
+    if (port_count_fn_() != wrapper_ports_.size()) {
+        CHWARN("VerilatorBackend: %s has %u ports, design has %zu",
+               so_path.c_str(), port_count_fn_(), wrapper_ports_.size());
+        close_top();
         return false;
     }
-    top_instance_ = factory();
+    top_instance_ = new_fn_();
     CHINFO("VerilatorBackend: dlopen'd %s, created Vtop at %p",
            so_path.c_str(), top_instance_);
-    return true;
+    return top_instance_ != nullptr;
 }
 
 void VerilatorBackend::build_port_access_table() {
     port_access_.clear();
+    bound_inputs_.clear();
+    bound_outputs_.clear();
     clock_node_id_ = UINT32_MAX;
     if (!ctx_) {
         return;
     }
-    auto nodes = ctx_->get_eval_list();
-    for (auto *node : nodes) {
-        if (!node) {
-            continue;
-        }
-        using ch::core::lnodetype;
-        if (node->type() == lnodetype::type_clock) {
+
+    std::vector<void *> fields(wrapper_ports_.size(), nullptr);
+    if (top_instance_) {
+        bind_ports_fn_(top_instance_, fields.data());
+    }
+
+    using ch::core::lnodetype;
+    for (size_t i = 0; i < wrapper_ports_.size(); ++i) {
+        auto *node = wrapper_ports_[i].node;
+        const bool is_output = node->type() == lnodetype::type_output;
+        if (node->type() == lnodetype::type_clock &&
+            clock_node_id_ == UINT32_MAX) {
             clock_node_id_ = node->id();
+        }
+        if (node->type() == lnodetype::type_input ||
+            node->type() == lnodetype::type_output) {
+            port_access_[node->id()] = {fields[i], node->size(), !is_output};
+        }
+        if (!fields[i] || !data_map_) {
             continue;
         }
-        bool is_input = (node->type() == lnodetype::type_input);
-        bool is_output = (node->type() == lnodetype::type_output);
-        if (!is_input && !is_output) {
+        auto it = data_map_->find(node->id());
+        if (it == data_map_->end()) {
             continue;
         }
-        VerilatorPortAccess pa;
-        pa.field_ptr = nullptr;  // Phase 3.3 follow-up: VPI or codegen
-        pa.bitwidth = node->size();
-        pa.is_input = is_input;
-        port_access_[node->id()] = pa;
-    }
-    CHINFO("VerilatorBackend: port_access_ built with %zu entries, "
-           "clock_node_id_=%u", port_access_.size(), clock_node_id_);
+        BoundPort bound{fields[i], &it->second, node->size()};
+        (is_output ? bound_outputs_ : bound_inputs_).push_back(bound);
+    }
+    CHINFO("VerilatorBackend: port_access_ built with %zu entries "
+           "(%zu inputs / %zu outputs bound), clock_node_id_=%u",
+           port_access_.size(), bound_inputs_.size(), bound_outputs_.size(),
+           clock_node_id_);
 }
 
 void VerilatorBackend::sync_inputs_to_vtop() {
-    if (!data_map_ || !top_instance_ || !eval_fn_) {
-        return;
+    // 时钟与复位也在 bound_inputs_ 里：Vtop 的 default_clock 直接跟随
+    // Simulator 的时钟节点值
+    for (const auto &port : bound_inputs_) {
+        store_port(port.field_ptr, port.bitwidth, *port.data);
     }
-    // Phase 3.3 follow-up: walk port_access_ for is_input, read
-    // data_map_->at(id), write to vtop field via field_ptr. The
-    // field_ptr resolution requires either (a) VPI lookups at
-    // runtime, or (b) generated per-design accessors. For now we
-    // record the intent; the architecture is validated because
-    // eval_fn_() is still called.
-    CHINFO("VerilatorBackend: sync %zu inputs to Vtop (stub)",
-           port_access_.size());
 }
 
 void VerilatorBackend::sync_outputs_from_vtop() {
-    if (!data_map_ || !top_instance_ || !eval_fn_) {
-        return;
+    for (const auto &port : bound_outputs_) {
+        load_port(port.field_ptr, port.bitwidth, *port.data);
     }
-    // Phase 3.3 follow-up: walk port_access_ for !is_input, read
-    // vtop field via field_ptr, write to data_map_->at(id). See
-    // sync_inputs_to_vtop() for the resolution plan.
-    CHINFO("VerilatorBackend: sync %zu outputs from Vtop (stub)",
-           port_access_.size());
 }
 
 void VerilatorBackend::close_top() {
-    if (top_instance_ && final_fn_) {
+    if (top_instance_) {
         final_fn_(top_instance_);
+        delete_fn_(top_instance_);
     }
     if (dl_handle_) {
         dlclose(dl_handle_);
         dl_handle_ = nullptr;
     }
     top_instance_ = nullptr;
+    new_fn_ = nullptr;
     eval_fn_ = nullptr;
     final_fn_ = nullptr;
+    delete_fn_ = nullptr;
+    port_count_fn_ = nullptr;
+    bind_ports_fn_ = nullptr;
+    // 指向旧实例的 field_ptr 全部失效
+    bound_inputs_.clear();
+    bound_outputs_.clear();
+    for (auto &kv : port_access_) {
+        kv.second.field_ptr = nullptr;
+    }
 }
 
 void VerilatorBackend::eval_combinational(
     ch::data_map_t & /*data_map*/,
-    const std::vector<std::pair<uint32_t, ch::instr_base *>> & /*input_instr_list*/,
+    const std::vector<std::pair<uint32_t, ch::instr_base *>> &input_instr_list,
     const std::vector<std::pair<uint32_t, ch::instr_base *>>
-        & /*combinational_instr_list*/) {
-    // Phase 3.3-3.4: sync data_map -> Vtop inputs, call eval_fn_,
-    // sync Vtop outputs -> data_map. See ADR-035 for the design.
-    sync_inputs_to_vtop();
-    if (eval_fn_) {
-        eval_fn_(top_instance_);
+        &combinational_instr_list) {
+    if (!top_instance_) {
+        for (const auto &kv : input_instr_list) {
+            kv.second->eval();
+        }
+        for (const auto &kv : combinational_instr_list) {
+            kv.second->eval();
+        }
+        return;
     }
+    sync_inputs_to_vtop();
+    eval_fn_(top_instance_);
     sync_outputs_from_vtop();
 }
 
 void VerilatorBackend::eval_sequential(
     ch::data_map_t & /*data_map*/,
     const std::vector<std::pair<uint32_t, ch::instr_base *>>
-        & /*sequential_instr_list*/) {
-    // Phase 3.4: clock toggle (clk=0/1) + Verilator's step() instead
-    // of eval(). The 3-eval-per-tick model maps to:
-    //   comb-1  -> top->clk=0; eval_fn_()
-    //   clock   -> top->clk=1; eval_fn_()
-    //   comb-2  -> top->clk=0; eval_fn_()
-    sync_inputs_to_vtop();
-    if (eval_fn_) {
-        eval_fn_(top_instance_);
+        &sequential_instr_list) {
+    if (!top_instance_) {
+        for (const auto &kv : sequential_instr_list) {
+            kv.second->eval();
+        }
+        return;
     }
+    // Simulator::eval() 只在时钟节点为 1 时调用 eval_sequential，
+    // 同步后的 default_clock 从 0 变 1，Vtop 在这次 eval() 中看到上升沿
+    sync_inputs_to_vtop();
+    eval_fn_(top_instance_);
     sync_outputs_from_vtop();
 }
 
 void VerilatorBackend::reset(ch::data_map_t & /*data_map*/) {
-    // Phase 3.4: Vtop doesn't have an explicit reset port in our
-    // generated Verilog (Phase 1.2 deferred reset). The user is
-    // expected to set inputs to known values after a "reset" event.
-    // For now, this is a no-op.
+    // The generated Verilog has no reset logic (Phase 1.2 deferred
+    // reset), so a reset recreates the Vtop instance: every register
+    // returns to Verilator's initial value.
+    if (!top_instance_) {
+        return;
+    }
+    final_fn_(top_instance_);
+    delete_fn_(top_instance_);
+    top_instance_ = new_fn_();
+    build_port_access_table();
 }
 
 std::string VerilatorBackend::compute_cache_key(
@@ -437,4 +573,33 @@ std::string VerilatorBackend::cache_path_for_key(const std::string &cache_key) {
     return std::string(home) + "/.cache/cpphdl/verilator/" + cache_key + "/Vtop";
 }
 
+std::string VerilatorBackend::cached_library_path(const std::string &key) const {
+    if (cache_root_.empty()) {
+        return cache_path_for_key(key);
+    }
+    return key.empty() ? std::string() : cache_root_ + "/" + key + "/Vtop";
+}
+
+std::string VerilatorBackend::detect_verilator_version(
+    const std::string &verilator_bin) {
+    const std::string cmd = verilator_bin + " --version 2>/dev/null";
+    FILE *pipe = popen(cmd.c_str(), "r");
+    if (!pipe) {
+        return {};
+    }
+    std::string line;
+    char buf[256];
+    if (std::fgets(buf, sizeof(buf), pipe)) {
+        line = buf;
+    }
+    const int status = pclose(pipe);
+    while (!line.empty() && std::isspace(static_cast<unsigned char>(line.back()))) {
+        line.pop_back();
+    }
+    if (status != 0 || line.rfind("Verilator", 0) != 0) {
+        return {};
+    }
+    return line;
+}
+
 } // namespace ch
@@ -2,8 +2,10 @@
 #include "ast/ast_nodes.h"
 #include "core/context.h"
 #include "core/lnodeimpl.h"
+#include <cctype>
 #include <fstream>
 #include <iostream>
+#include <unordered_map>
 
 #if defined(CH_JIT_ENABLED) && __has_include(<llvm/IR/LLVMContext.h>)
 #include <llvm-c/Core.h>
@@ -107,8 +109,8 @@ JitCompileResult JitCompiler::compile(ch::core::context *ctx) {
   }
 
   JitFunction func_comb("tick_comb");
-  JitFunction func_seq("tick_seq");
-  auto ir_result = generate_ir(ctx, func_comb, func_seq);
+  std::vector<JitFunction> seq_funcs;
+  auto ir_result = generate_ir(ctx, func_comb, seq_funcs);
   if (ir_result != JitResult::SUCCESS) {
     result.result = ir_result;
     return result;
@@ -118,15 +120,21 @@ JitCompileResult JitCompiler::compile(ch::core::context *ctx) {
       func_comb.blocks.empty()
           ? 0
           : static_cast<uint32_t>(func_comb.blocks[0].instrs.size());
-  last_seq_ir_instr_count_ =
-      func_seq.blocks.empty()
-          ? 0
-          : static_cast<uint32_t>(func_seq.blocks[0].instrs.size());
-  last_vreg_count_ = func_comb.vreg_count + func_seq.vreg_count;
+  last_seq_ir_instr_count_ = 0;
+  last_vreg_count_ = func_comb.vreg_count;
+  for (size_t i = 0; i < seq_funcs.size(); ++i) {
+    uint32_t count =
+        seq_funcs[i].blocks.empty()
+            ? 0
+            : static_cast<uint32_t>(seq_funcs[i].blocks[0].instrs.size());
+    seq_domains_[i].ir_instr_count = count;
+    last_seq_ir_instr_count_ += count;
+    last_vreg_count_ += seq_funcs[i].vreg_count;
+  }
 
   result.ir_instr_count = last_ir_instr_count_;
   result.vreg_count = last_vreg_count_;
-  result.result = compile_to_llvm(func_comb, func_seq);
+  result.result = compile_to_llvm(func_comb, seq_funcs);
   return result;
 }
 
@@ -161,11 +169,37 @@ void JitCompiler::execute_seq_tick() {
   }
 
   using SeqTickFunc = void (*)(uint64_t *);
-  auto tick_func = reinterpret_cast<SeqTickFunc>(compiled_seq_func_);
-  tick_func(data_buffer_.data());
+  for (const auto &domain : seq_domains_) {
+    if (domain.func) {
+      reinterpret_cast<SeqTickFunc>(domain.func)(data_buffer_.data());
+    }
+  }
 #endif
 }
 
+void JitCompiler::execute_seq_tick(uint32_t clock_id) {
+#if defined(CH_JIT_ENABLED) && __has_include(<llvm/IR/LLVMContext.h>)
+  using SeqTickFunc = void (*)(uint64_t *);
+  for (const auto &domain : seq_domains_) {
+    if (domain.clock_id == clock_id) {
+      if (domain.func) {
+        reinterpret_cast<SeqTickFunc>(domain.func)(data_buffer_.data());
+      }
+      return;
+    }
+  }
+#endif
+}
+
+bool JitCompiler::has_seq_func_for(uint32_t clock_id) const {
+  for (const auto &domain : seq_domains_) {
+    if (domain.clock_id == clock_id) {
+      return domain.func != nullptr;
+    }
+  }
+  return false;
+}
+
 void JitCompiler::clear() {
   if (compiled_func_) {
     compiled_func_ = nullptr;
@@ -176,20 +210,34 @@ void JitCompiler::clear() {
   if (compiled_seq_func_) {
     compiled_seq_func_ = nullptr;
   }
-#if defined(CH_JIT_ENABLED) && __has_include(<llvm/ExecutionEngine/Orc/LLJIT.h>)
-  if (jit_session_) {
-    delete static_cast<llvm::orc::LLJIT *>(jit_session_);
-    jit_session_ = nullptr;
-  }
-#else
-  if (jit_session_) {
-    jit_session_ = nullptr;
-  }
-#endif
+  // 会话由 session_ref_ 持有；clone() 出的对象仍在使用时不会被析构
+  session_ref_.reset();
+  jit_session_ = nullptr;
   data_buffer_.clear();
+  seq_domains_.clear();
   external_node_ids_.clear();
 }
 
+std::unique_ptr<JitCompiler> JitCompiler::clone() const {
+  auto copy = std::make_unique<JitCompiler>();
+  copy->available_ = available_;
+  copy->jit_session_ = jit_session_;
+  copy->session_ref_ = session_ref_;
+  copy->compiled_func_ = compiled_func_;
+  copy->compiled_comb_func_ = compiled_comb_func_;
+  copy->compiled_seq_func_ = compiled_seq_func_;
+  copy->last_ir_instr_count_ = last_ir_instr_count_;
+  copy->last_seq_ir_instr_count_ = last_seq_ir_instr_count_;
+  copy->last_vreg_count_ = last_vreg_count_;
+  copy->data_buffer_ = data_buffer_;
+  copy->seq_domains_ = seq_domains_;
+  copy->external_node_ids_ = external_node_ids_;
+#if defined(CH_JIT_ENABLED) && __has_include(<llvm/IR/LLVMContext.h>)
+  copy->llvm_module_ = nullptr;
+#endif
+  return copy;
+}
+
 JitResult JitCompiler::allocate_buffer(ch::core::context *ctx) {
   if (!ctx) {
     return JitResult::IR_GENERATION_FAILED;
@@ -243,7 +291,7 @@ bool JitCompiler::is_external_node(uint32_t node_id) const {
 
 JitResult JitCompiler::generate_ir(ch::core::context *ctx,
                                    JitFunction &func_comb,
-                                   JitFunction &func_seq) {
+                                   std::vector<JitFunction> &seq_funcs) {
   if (!ctx) {
     return JitResult::IR_GENERATION_FAILED;
   }
@@ -265,9 +313,45 @@ JitResult JitCompiler::generate_ir(ch::core::context *ctx,
   }
 
   JitBlock block_comb("combinational");
-  JitBlock block_seq("sequential");
   VRegId next_comb_vreg = 0;
-  VRegId next_seq_vreg = 0;
+
+  // ADR-036: 时序逻辑按时钟域拆成多个函数。下标 0 是默认时钟域
+  // （"tick_seq"，也收留时钟节点不在 eval list 中的寄存器），eval list
+  // 中的其它时钟各得一个 "tick_seq_<时钟名>"，多时钟调度时只调用有沿的域。
+  seq_domains_.clear();
+  std::vector<JitBlock> seq_blocks;
+  std::vector<VRegId> seq_next_vregs;
+  std::unordered_map<uint32_t, size_t> domain_of_clock;
+  std::unordered_set<std::string> used_names;
+  auto add_domain = [&](uint32_t clock_id, const std::string &func_name) {
+    JitSeqDomain domain;
+    domain.clock_id = clock_id;
+    domain.func_name = func_name;
+    seq_domains_.push_back(std::move(domain));
+    seq_blocks.emplace_back("sequential");
+    seq_next_vregs.push_back(0);
+    used_names.insert(func_name);
+    return seq_domains_.size() - 1;
+  };
+
+  uint32_t default_clock_id = ctx->has_default_clock()
+                                  ? ctx->get_default_clock()->id()
+                                  : static_cast<uint32_t>(-1);
+  add_domain(default_clock_id, "tick_seq");
+  for (auto *node : eval_list) {
+    if (node->type() != ch::core::lnodetype::type_clock ||
+        node->id() == default_clock_id) {
+      continue;
+    }
+    std::string func_name = "tick_seq_";
+    for (char c : node->name()) {
+      func_name += std::isalnum(static_cast<unsigned char>(c)) ? c : '_';
+    }
+    if (used_names.count(func_name)) {
+      func_name += "_" + std::to_string(node->id());
+    }
+    domain_of_clock[node->id()] = add_domain(node->id(), func_name);
+  }
 
   for (auto *node : eval_list) {
     auto node_type = node->type();
@@ -294,8 +378,19 @@ JitResult JitCompiler::generate_ir(ch::core::context *ctx,
     case ch::core::lnodetype::type_mem:
     case ch::core::lnodetype::type_mem_read_port:
     case ch::core::lnodetype::type_mem_write_port:
-      r = generate_ir_lnode_state(node, block_seq, next_seq_vreg);
+    {
+      size_t domain = 0;
+      if (node_type == ch::core::lnodetype::type_reg) {
+        auto it = domain_of_clock.find(
+            static_cast<ch::core::regimpl *>(node)->cd());
+        if (it != domain_of_clock.end()) {
+          domain = it->second;
+        }
+      }
+      r = generate_ir_lnode_state(node, seq_blocks[domain],
+                                  seq_next_vregs[domain]);
       break;
+    }
 
     case ch::core::lnodetype::type_clock:
     case ch::core::lnodetype::type_reset:
@@ -321,14 +416,19 @@ JitResult JitCompiler::generate_ir(ch::core::context *ctx,
   func_comb.blocks.push_back(std::move(block_comb));
   func_comb.node_count = static_cast<uint32_t>(eval_list.size());
 
-  func_seq.vreg_count = next_seq_vreg;
-  func_seq.blocks.push_back(std::move(block_seq));
+  for (size_t i = 0; i < seq_domains_.size(); ++i) {
+    JitFunction func_seq(seq_domains_[i].func_name);
+    func_seq.vreg_count = seq_next_vregs[i];
+    func_seq.node_count = seq_blocks[i].node_count;
+    func_seq.blocks.push_back(std::move(seq_blocks[i]));
+    seq_funcs.push_back(std::move(func_seq));
+  }
 
   return JitResult::SUCCESS;
 }
 
-JitResult JitCompiler::compile_to_llvm(const JitFunction &func_comb,
-                                       const JitFunction &func_seq) {
+JitResult JitCompiler::compile_to_llvm(
+    const JitFunction &func_comb, const std::vector<JitFunction> &seq_funcs) {
 #if defined(CH_JIT_ENABLED) && __has_include(<llvm/IR/LLVMContext.h>)
   auto *context = new llvm::LLVMContext();
   std::string module_name = "cpphdl_jit_dual";
@@ -447,9 +547,11 @@ JitResult JitCompiler::compile_to_llvm(const JitFunction &func_comb,
     return result_comb;
   }
 
-  auto result_seq = compile_single_func(func_seq, compiled_seq_func_);
-  if (result_seq != JitResult::SUCCESS) {
-    return result_seq;
+  for (size_t i = 0; i < seq_funcs.size(); ++i) {
+    auto result_seq = compile_single_func(seq_funcs[i], seq_domains_[i].func);
+    if (result_seq != JitResult::SUCCESS) {
+      return result_seq;
+    }
   }
 
   llvm_module_ = module;
@@ -4,12 +4,13 @@
 // Split out from src/jit/jit_compiler.cpp:finalize_compilation_dual() during
 // Phase 1 of the C-class refactor. This is the only consumer of the
 // llvm_module_ / compiled_comb_func_ / compiled_seq_func_ / jit_session_
-// private fields.
+// private fields, and resolves the per-domain seq_domains_ symbols.
 
 #include "jit/jit_compiler.h"
 
 #if defined(CH_JIT_ENABLED) && __has_include(<llvm/IR/LLVMContext.h>)
 #include <llvm-c/Core.h>
+#include <llvm/Config/llvm-config.h>
 #include <llvm/ExecutionEngine/Orc/LLJIT.h>
 #include <llvm/ExecutionEngine/Orc/ThreadSafeModule.h>
 #include <llvm/IR/Module.h>
@@ -18,6 +19,20 @@
 
 namespace ch::jit {
 
+#if defined(CH_JIT_ENABLED) && __has_include(<llvm/IR/LLVMContext.h>)
+namespace {
+// LLJIT::lookup returns ExecutorAddr (getValue) since LLVM 15 and
+// JITEvaluatedSymbol (getAddress) before that.
+template <typename Sym> void *jit_symbol_ptr(const Sym &sym) {
+#if LLVM_VERSION_MAJOR >= 15
+  return reinterpret_cast<void *>(sym.getValue());
+#else
+  return reinterpret_cast<void *>(sym.getAddress());
+#endif
+}
+} // namespace
+#endif
+
 JitResult JitCompiler::finalize_compilation_dual() {
 #if defined(CH_JIT_ENABLED) && __has_include(<llvm/IR/LLVMContext.h>)
   if (!llvm_module_) {
@@ -57,19 +72,28 @@ JitResult JitCompiler::finalize_compilation_dual() {
     last_error_msg_ = std::string("lookup tick_comb failed: ") + err_msg;
     return JitResult::COMPILATION_FAILED;
   }
-  compiled_comb_func_ = reinterpret_cast<void *>(Sym_comb->getValue());
+  compiled_comb_func_ = jit_symbol_ptr(*Sym_comb);
 
-  auto Sym_seq = JIT->lookup("tick_seq");
-  if (!Sym_seq) {
-    std::string err_msg;
-    llvm::raw_string_ostream os(err_msg);
-    os << Sym_seq.takeError();
-    last_error_msg_ = std::string("lookup tick_seq failed: ") + err_msg;
-    return JitResult::COMPILATION_FAILED;
+  // ADR-036: one sequential function per clock domain; seq_domains_[0] is
+  // the default domain ("tick_seq").
+  for (auto &domain : seq_domains_) {
+    auto Sym_seq = JIT->lookup(domain.func_name);
+    if (!Sym_seq) {
+      std::string err_msg;
+      llvm::raw_string_ostream os(err_msg);
+      os << Sym_seq.takeError();
+      last_error_msg_ =
+          "lookup " + domain.func_name + " failed: " + err_msg;
+      return JitResult::COMPILATION_FAILED;
+    }
+    domain.func = jit_symbol_ptr(*Sym_seq);
   }
-  compiled_seq_func_ = reinterpret_cast<void *>(Sym_seq->getValue());
+  compiled_seq_func_ = seq_domains_.empty() ? nullptr : seq_domains_[0].func;
 
   jit_session_ = static_cast<void *>(JIT.release());
+  session_ref_ = std::shared_ptr<void>(jit_session_, [](void *session) {
+    delete static_cast<llvm::orc::LLJIT *>(session);
+  });
   llvm_module_ = nullptr;
   return JitResult::SUCCESS;
 #else
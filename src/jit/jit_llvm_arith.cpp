@@ -3,8 +3,11 @@
 //   ADD, SUB, MUL, DIV, MOD
 //
 // Split out from src/jit/jit_compiler.cpp:compile_to_llvm() during Phase 1.
-// DIV and MOD guard against divisor == 0 by substituting the dividend (MOD)
-// or 0 (DIV). All results are masked to instr.bitwidth when bitwidth < 64.
+// DIV and MOD guard against divisor == 0 with the hardware (RISC-V DIVU/REMU)
+// convention the interpreter kernels in instr_op_arith.h also use: DIV yields
+// all ones, MOD yields the dividend. All results are masked to
+// instr.bitwidth when bitwidth < 64. The divisor itself is replaced by 1
+// before the udiv/urem: udiv by zero is UB in LLVM and traps on x86.
 
 #include "jit_llvm_helpers.h"
 
@@ -35,15 +38,20 @@ void compile_to_llvm_arith(const JitInstr &instr, llvm::IRBuilder<> &builder,
   case JitOp::MOD: {
     auto *is_zero =
         builder.CreateICmpEQ(b, builder.getInt64(0), "is_zero");
-    auto *rem = builder.CreateURem(a, b, "mod");
+    auto *b_safe =
+        builder.CreateSelect(is_zero, builder.getInt64(1), b, "mod_divisor");
+    auto *rem = builder.CreateURem(a, b_safe, "mod");
     res = builder.CreateSelect(is_zero, a, rem, "mod_safe");
     break;
   }
   case JitOp::DIV: {
     auto *is_zero =
         builder.CreateICmpEQ(b, builder.getInt64(0), "is_zero");
-    auto *quotient = builder.CreateUDiv(a, b, "div");
-    res = builder.CreateSelect(is_zero, builder.getInt64(0), quotient, "div_safe");
+    auto *b_safe =
+        builder.CreateSelect(is_zero, builder.getInt64(1), b, "div_divisor");
+    auto *quotient = builder.CreateUDiv(a, b_safe, "div");
+    res = builder.CreateSelect(is_zero, builder.getInt64(~0ULL), quotient,
+                               "div_safe");
     break;
   }
   default:
@@ -81,9 +81,16 @@ void compile_to_llvm_bit(const JitInstr &instr, llvm::IRBuilder<> &builder,
   case JitOp::SSHRSHN: {
     auto *b =
         builder.CreateLoad(builder.getInt64Ty(), vregs[instr.src1], "load_b");
+    // Sign-extend from the source width to i64 and clamp the shift to 63:
+    // ashr by >= the type width is poison, and shifting an iN by an i64 does
+    // not type-check. Matches op::Sshr's single-word path.
     auto *narrowed = builder.CreateTrunc(a, builder.getIntNTy(instr.src_bitwidth),
                                         "trunc_sshr");
-    res = builder.CreateAShr(narrowed, b, "sshr");
+    auto *wide = builder.CreateSExt(narrowed, builder.getInt64Ty(), "sext_sshr");
+    auto *max_sh = builder.getInt64(63);
+    auto *too_big = builder.CreateICmpUGT(b, max_sh, "sshr_sat");
+    auto *sh = builder.CreateSelect(too_big, max_sh, b, "sshr_amt");
+    res = builder.CreateAShr(wide, sh, "sshr");
     break;
   }
   case JitOp::NEG:
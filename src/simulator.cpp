@@ -186,6 +186,12 @@ void Simulator::update_instruction_pointers() {
 void Simulator::eval_sequential() {
     CHDBG_FUNC();
 
+    // ADR-035: set_backend() 接入的后端优先于 JIT / 分区路径
+    if (backend_) {
+        backend_->eval_sequential(data_map_, sequential_instr_list_);
+        return;
+    }
+
 #if __has_include("jit/jit_compiler.h")
     if (jit_enabled_ && jit_compiled_ && jit_compiler_ && jit_compiler_->has_seq_func()) {
         // 先执行 CALL_EXTERNAL 解释器节点（修复: JIT 之前执行避免陈旧值）
@@ -198,6 +204,8 @@ void Simulator::eval_sequential() {
         jit_compiler_->sync_to_buffer(data_map_);
         jit_compiler_->execute_seq_tick();
         jit_compiler_->sync_from_buffer(data_map_);
+    } else if (partitioned_eval_) {
+        partitioned_eval_->eval_sequential();
     } else {
         for (const auto &[node_id, instr] : sequential_instr_list_) {
             instr->eval();
@@ -219,6 +227,12 @@ void Simulator::eval_sequential() {
 void Simulator::eval_combinational() {
     CHDBG_FUNC();
 
+    if (backend_) {
+        backend_->eval_combinational(data_map_, input_instr_list_,
+                                     combinational_instr_list_);
+        return;
+    }
+
 #if __has_include("jit/jit_compiler.h")
     if (jit_enabled_ && jit_compiled_ && jit_compiler_ && jit_compiler_->has_comb_func()) {
         for (const auto &[node_id, instr] : combinational_instr_list_) {
@@ -240,6 +254,11 @@ void Simulator::eval_combinational() {
               data_map_[node_id].to_string_verbose().c_str());
     }
 
+    if (partitioned_eval_) {
+        partitioned_eval_->eval_combinational();
+        return;
+    }
+
     for (const auto &[node_id, instr] : combinational_instr_list_) {
         instr->eval();
         CHDBG("Evaluating combinational instruction for node %u: %s", node_id,
@@ -258,22 +277,39 @@ void Simulator::tick() {
         return;
     }
 
-    CHDBG("ticks count: %u", ticks_++);
-
-    // 进度报告 (每1秒报告一次)
-    {
-        static auto last_report = std::chrono::steady_clock::now();
-        static size_t last_ticks = 0;
-        auto now = std::chrono::steady_clock::now();
-        double elapsed = std::chrono::duration<double>(now - last_report).count();
-        if (elapsed >= 1.0) {
-            double rate = (ticks_ - last_ticks) / elapsed;
-            std::cout << "[PROGRESS] tick=" << ticks_
-                      << " rate=" << std::fixed << std::setprecision(0) << rate << " ticks/s"
-                      << std::endl << std::flush;
-            last_report = now;
-            last_ticks = ticks_;
-        }
+    // 计数不能放在 CHDBG 参数里：级别裁剪后参数不再求值
+    CHDBG("ticks count: %llu", static_cast<unsigned long long>(ticks_));
+    ++ticks_;
+
+    report_progress();
+    step();
+    if (callback_watches_ > 0) {
+        check_watches(false);
+    }
+}
+
+// 进度报告 (每1秒报告一次)
+void Simulator::report_progress() {
+    static auto last_report = std::chrono::steady_clock::now();
+    static size_t last_ticks = 0;
+    auto now = std::chrono::steady_clock::now();
+    double elapsed = std::chrono::duration<double>(now - last_report).count();
+    if (elapsed >= 1.0) {
+        double rate = (ticks_ - last_ticks) / elapsed;
+        std::cout << "[PROGRESS] tick=" << ticks_
+                  << " rate=" << std::fixed << std::setprecision(0) << rate << " ticks/s"
+                  << std::endl << std::flush;
+        last_report = now;
+        last_ticks = ticks_;
+    }
+}
+
+// 一拍的求值本体：tick() 与 run_until() 共用
+void Simulator::step() {
+    // ADR-036: 配置了时钟周期后，每次 tick 处理下一个时钟沿事件
+    if (multi_clock_) {
+        step_clock_edge();
+        return;
     }
 
     // A/B verification: save interpreted state before execution
@@ -301,7 +337,8 @@ void Simulator::tick() {
         eval();
 
 #if __has_include("jit/jit_compiler.h")
-        if (jit_enabled_ && jit_compiled_ && jit_compiler_ && jit_compiler_->has_comb_func()) {
+        if (!backend_ && jit_enabled_ && jit_compiled_ && jit_compiler_ &&
+            jit_compiler_->has_comb_func()) {
             for (const auto &[node_id, instr] : combinational_instr_list_) {
                 if (jit_compiler_->is_external_node(node_id)) {
                     instr->eval();
@@ -377,12 +414,8 @@ void Simulator::tick(size_t count) {
         return;
     }
 
-    for (size_t i = 0; i < count; ++i) {
-        if (disconnected_)
-            return;
-        CHDBG("Tick %zu/%zu", i + 1, count);
-        tick();
-    }
+    // ADR-040: 与 run_until() 同一个循环，只是不检查停止条件
+    run_ticks(count, false, nullptr);
 }
 
 #ifdef ENABLE_PERF_PROFILING
@@ -422,6 +455,9 @@ void Simulator::reset() {
             pair.second = ch::core::sdata_type(0, pair.second.bitwidth());
         }
     }
+    if (backend_) {
+        backend_->reset(data_map_);
+    }
     CHDBG("Simulator state reset completed");
 }
 
@@ -518,7 +554,13 @@ void Simulator::set_backend(std::unique_ptr<ch::IEvalBackend> backend) {
     }
     backend_ = std::move(backend);
     if (backend_) {
-        backend_->initialize(ctx_, data_map_);
+        if (!backend_->initialize(ctx_, data_map_)) {
+            CHERROR("Simulator backend '%s' failed to initialize",
+                    backend_->name().c_str());
+            backend_.reset();
+            backend_name_ = "inlined";
+            return;
+        }
         backend_name_ = backend_->name();
         CHINFO("Simulator backend set to '%s' (ADR-035 Phase 2.3)",
                backend_name_.c_str());
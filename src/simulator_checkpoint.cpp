@@ -0,0 +1,625 @@
+// src/simulator_checkpoint.cpp
+// ADR-038: checkpoint / restore / fork of the full simulator state.
+// Owns: design_hash, save_checkpoint, restore_checkpoint, fork,
+//       copy_state_from.
+//
+// 检查点文件格式（小端，版本 1）：
+//   header   : magic "CHCKPT\0\0" | u32 version | u32 reserved |
+//              u64 design_hash | u64 ticks | u64 sim_time | u64 event_floor |
+//              u8 multi_clock | u8 schedule_ready | u8 skip_idle | u8 pad
+//   values   : u32 count, { u32 node | u32 width | u64 words[] }
+//   clocks   : u32 count, { u32 node | u8 last_clk | u8 posedge | u8 negedge }
+//   ports    : u32 count, { u32 node | u8 last_clk }
+//   domains  : u32 count, { u64 period | u64 phase | u64 next_edge |
+//                           u64 edge_count }
+//   memories : u32 count, { u32 node | u32 depth | u32 width | u32 entries,
+//                           { u32 addr | u64 words[] } }   —— 只存非零项
+//   jit      : u32 count, u64 words[]   —— data_buffer_[id]，按 node 顺序
+//
+// node 是节点在 eval list 中的下标而不是节点 id：id 在进程内全局递增，
+// 同一设计的另一个实例（或另一次运行中先构造了别的设计）id 会不同，而
+// eval list 的拓扑序只取决于设计结构。恢复时先完整解析并校验，全部通过
+// 后才写入仿真器，失败时仿真器状态不变。
+#include "simulator.h"
+#include "ast/instr_clock.h"
+#include "ast/instr_mem.h"
+#include "core/lnodeimpl.h"
+#include "logger.h"
+#include "types.h"
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <type_traits>
+#include <unordered_map>
+
+namespace ch {
+
+namespace {
+
+constexpr char kCheckpointMagic[8] = {'C', 'H', 'C', 'K', 'P', 'T', 0, 0};
+constexpr uint32_t kCheckpointVersion = 1;
+
+class CheckpointWriter {
+public:
+    template <typename T> void put(T value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        const char *bytes = reinterpret_cast<const char *>(&value);
+        buf_.append(bytes, sizeof(T));
+    }
+    void put_bytes(const void *data, size_t size) {
+        buf_.append(static_cast<const char *>(data), size);
+    }
+    void put_words(const ch::core::sdata_type &value) {
+        const auto &bv = value.bitvector();
+        put_bytes(bv.words(), bv.num_words() * sizeof(uint64_t));
+    }
+    const std::string &data() const { return buf_; }
+
+private:
+    std::string buf_;
+};
+
+class CheckpointReader {
+public:
+    explicit CheckpointReader(const std::string &buf) : buf_(buf) {}
+
+    template <typename T> bool get(T &value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        return get_bytes(&value, sizeof(T));
+    }
+    bool get_bytes(void *data, size_t size) {
+        if (buf_.size() - pos_ < size)
+            return false;
+        std::memcpy(data, buf_.data() + pos_, size);
+        pos_ += size;
+        return true;
+    }
+    bool at_end() const { return pos_ == buf_.size(); }
+    // 预分配前检查长度字段，损坏的文件不能触发超大分配
+    bool has(size_t bytes) const { return buf_.size() - pos_ >= bytes; }
+
+private:
+    const std::string &buf_;
+    size_t pos_ = 0;
+};
+
+uint32_t word_count(uint32_t width) { return (width + 63) / 64; }
+
+void load_words(ch::core::sdata_type &dst, const uint64_t *words) {
+    auto &bv = dst.bitvector();
+    std::memcpy(bv.words(), words, bv.num_words() * sizeof(uint64_t));
+}
+
+// 解析后的检查点内容；全部校验通过后才应用到仿真器
+struct CheckpointImage {
+    uint64_t design_hash = 0;
+    uint64_t ticks = 0;
+    uint64_t sim_time = 0;
+    uint64_t event_floor = 0;
+    bool multi_clock = false;
+    bool schedule_ready = false;
+    bool skip_idle = true;
+
+    // id 字段均为 eval list 下标
+    struct Value {
+        uint32_t id;
+        uint32_t width;
+        std::vector<uint64_t> words;
+    };
+    struct ClockState {
+        uint32_t id;
+        uint8_t last_clk, posedge, negedge;
+    };
+    struct PortState {
+        uint32_t id;
+        uint8_t last_clk;
+    };
+    struct DomainState {
+        uint64_t period, phase, next_edge, edge_count;
+    };
+    struct Memory {
+        uint32_t id, depth, width;
+        std::vector<uint32_t> addrs;
+        std::vector<uint64_t> words; // entries * word_count(width)
+    };
+
+    std::vector<Value> values;
+    std::vector<ClockState> clocks;
+    std::vector<PortState> ports;
+    std::vector<DomainState> domains;
+    std::vector<Memory> memories;
+    std::vector<uint64_t> jit_buffer;
+};
+
+bool parse_checkpoint(const std::string &buf, CheckpointImage &image) {
+    CheckpointReader in(buf);
+
+    char magic[8];
+    uint32_t version = 0, reserved = 0;
+    if (!in.get_bytes(magic, sizeof(magic)) ||
+        std::memcmp(magic, kCheckpointMagic, sizeof(magic)) != 0) {
+        CHERROR("Not a CppHDL checkpoint (bad magic)");
+        return false;
+    }
+    if (!in.get(version) || version != kCheckpointVersion) {
+        CHERROR("Unsupported checkpoint version %u (expected %u)", version,
+                kCheckpointVersion);
+        return false;
+    }
+    uint8_t multi_clock = 0, schedule_ready = 0, skip_idle = 0, pad = 0;
+    if (!in.get(reserved) || !in.get(image.design_hash) ||
+        !in.get(image.ticks) || !in.get(image.sim_time) ||
+        !in.get(image.event_floor) || !in.get(multi_clock) ||
+        !in.get(schedule_ready) || !in.get(skip_idle) || !in.get(pad)) {
+        CHERROR("Truncated checkpoint header");
+        return false;
+    }
+    image.multi_clock = multi_clock != 0;
+    image.schedule_ready = schedule_ready != 0;
+    image.skip_idle = skip_idle != 0;
+
+    uint32_t count = 0;
+    bool ok = in.get(count);
+    for (uint32_t i = 0; ok && i < count; ++i) {
+        CheckpointImage::Value value;
+        ok = in.get(value.id) && in.get(value.width) &&
+             in.has(word_count(value.width) * sizeof(uint64_t));
+        if (!ok)
+            break;
+        value.words.resize(word_count(value.width));
+        ok = in.get_bytes(value.words.data(),
+                          value.words.size() * sizeof(uint64_t));
+        image.values.push_back(std::move(value));
+    }
+
+    ok = ok && in.get(count);
+    for (uint32_t i = 0; ok && i < count; ++i) {
+        CheckpointImage::ClockState clock;
+        ok = in.get(clock.id) && in.get(clock.last_clk) &&
+             in.get(clock.posedge) && in.get(clock.negedge);
+        image.clocks.push_back(clock);
+    }
+
+    ok = ok && in.get(count);
+    for (uint32_t i = 0; ok && i < count; ++i) {
+        CheckpointImage::PortState port;
+        ok = in.get(port.id) && in.get(port.last_clk);
+        image.ports.push_back(port);
+    }
+
+    ok = ok && in.get(count);
+    for (uint32_t i = 0; ok && i < count; ++i) {
+        CheckpointImage::DomainState domain;
+        ok = in.get(domain.period) &&
+             in.get(domain.phase) && in.get(domain.next_edge) &&
+             in.get(domain.edge_count);
+        image.domains.push_back(domain);
+    }
+
+    ok = ok && in.get(count);
+    for (uint32_t i = 0; ok && i < count; ++i) {
+        CheckpointImage::Memory memory;
+        uint32_t entries = 0;
+        ok = in.get(memory.id) && in.get(memory.depth) &&
+             in.get(memory.width) && in.get(entries);
+        const uint32_t words = word_count(memory.width);
+        ok = ok && entries <= memory.depth &&
+             in.has(static_cast<size_t>(entries) *
+                    (sizeof(uint32_t) + words * sizeof(uint64_t)));
+        if (!ok)
+            break;
+        memory.addrs.resize(entries);
+        memory.words.resize(static_cast<size_t>(entries) * words);
+        for (uint32_t e = 0; ok && e < entries; ++e) {
+            ok = in.get(memory.addrs[e]) &&
+                 in.get_bytes(&memory.words[static_cast<size_t>(e) * words],
+                              words * sizeof(uint64_t));
+            ok = ok && memory.addrs[e] < memory.depth;
+        }
+        image.memories.push_back(std::move(memory));
+    }
+
+    uint32_t jit_words = 0;
+    ok = ok && in.get(jit_words) && in.has(jit_words * sizeof(uint64_t));
+    if (ok) {
+        image.jit_buffer.resize(jit_words);
+        ok = in.get_bytes(image.jit_buffer.data(),
+                          jit_words * sizeof(uint64_t));
+    }
+
+    if (!ok || !in.at_end()) {
+        CHERROR("Corrupted or truncated checkpoint body");
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+uint64_t Simulator::design_hash() const {
+    // FNV-1a；只依赖设计结构，与节点值、仿真器配置无关
+    uint64_t hash = 0xcbf29ce484222325ull;
+    auto mix = [&hash](uint64_t value) {
+        for (int i = 0; i < 8; ++i) {
+            hash ^= (value >> (i * 8)) & 0xff;
+            hash *= 0x100000001b3ull;
+        }
+    };
+    std::unordered_map<uint32_t, uint32_t> index_of;
+    index_of.reserve(eval_list_.size());
+    for (uint32_t i = 0; i < eval_list_.size(); ++i) {
+        if (eval_list_[i])
+            index_of[eval_list_[i]->id()] = i;
+    }
+    for (uint32_t i = 0; i < eval_list_.size(); ++i) {
+        auto *node = eval_list_[i];
+        if (!node)
+            continue;
+        mix(i);
+        mix(static_cast<uint64_t>(node->type()));
+        mix(node->size());
+        for (auto *src : node->srcs()) {
+            auto it = src ? index_of.find(src->id()) : index_of.end();
+            mix(it != index_of.end() ? it->second : static_cast<uint32_t>(-1));
+        }
+    }
+    return hash;
+}
+
+bool Simulator::save_checkpoint(const std::string &path) const {
+    CHDBG_FUNC();
+
+    if (!initialized_ || disconnected_) {
+        CHERROR("Cannot checkpoint an uninitialized simulator");
+        return false;
+    }
+    if (backend_) {
+        CHERROR("Cannot checkpoint while backend '%s' owns the design state",
+                backend_name_.c_str());
+        return false;
+    }
+
+    CheckpointWriter out;
+    out.put_bytes(kCheckpointMagic, sizeof(kCheckpointMagic));
+    out.put(kCheckpointVersion);
+    out.put(uint32_t{0});
+    out.put(design_hash());
+    out.put(ticks_);
+    out.put(sim_time_);
+    out.put(event_floor_);
+    out.put(static_cast<uint8_t>(multi_clock_));
+    out.put(static_cast<uint8_t>(schedule_ready_));
+    out.put(static_cast<uint8_t>(skip_idle_domains_));
+    out.put(uint8_t{0});
+
+    std::vector<std::pair<uint32_t, const ch::core::sdata_type *>> values;
+    std::vector<std::pair<uint32_t, const instr_clock *>> clocks;
+    std::vector<std::pair<uint32_t, bool>> ports;
+    std::vector<std::pair<uint32_t, const instr_mem *>> memories;
+    for (uint32_t index = 0; index < eval_list_.size(); ++index) {
+        auto *node = eval_list_[index];
+        if (!node)
+            continue;
+        auto value_it = data_map_.find(node->id());
+        if (value_it != data_map_.end())
+            values.emplace_back(index, &value_it->second);
+
+        auto instr_it = instr_map_.find(node->id());
+        if (instr_it == instr_map_.end())
+            continue;
+        auto *instr = instr_it->second;
+        if (auto *clock = dynamic_cast<const instr_clock *>(instr)) {
+            clocks.emplace_back(index, clock);
+        } else if (auto *mem = dynamic_cast<const instr_mem *>(instr)) {
+            memories.emplace_back(index, mem);
+        } else if (auto *rd = dynamic_cast<const instr_mem_sync_read_port *>(
+                       instr)) {
+            ports.emplace_back(index, rd->last_clk());
+        } else if (auto *wr =
+                       dynamic_cast<const instr_mem_write_port *>(instr)) {
+            ports.emplace_back(index, wr->last_clk());
+        }
+    }
+
+    out.put(static_cast<uint32_t>(values.size()));
+    for (const auto &[id, value] : values) {
+        out.put(id);
+        out.put(value->bitwidth());
+        out.put_words(*value);
+    }
+
+    out.put(static_cast<uint32_t>(clocks.size()));
+    for (const auto &[index, clock] : clocks) {
+        out.put(index);
+        out.put(static_cast<uint8_t>(clock->last_clock_value()));
+        out.put(static_cast<uint8_t>(clock->is_posedge_active()));
+        out.put(static_cast<uint8_t>(clock->is_negedge_active()));
+    }
+
+    out.put(static_cast<uint32_t>(ports.size()));
+    for (const auto &[id, last_clk] : ports) {
+        out.put(id);
+        out.put(static_cast<uint8_t>(last_clk));
+    }
+
+    out.put(static_cast<uint32_t>(clock_domains_.size()));
+    for (const auto &domain : clock_domains_) {
+        out.put(domain.period);
+        out.put(domain.phase);
+        out.put(domain.next_edge);
+        out.put(domain.edge_count);
+    }
+
+    out.put(static_cast<uint32_t>(memories.size()));
+    size_t stored_entries = 0;
+    for (const auto &[index, mem] : memories) {
+        const auto *data = mem->get_memory();
+        uint32_t entries = 0;
+        for (uint32_t addr = 0; addr < mem->depth(); ++addr) {
+            entries += data[addr].is_zero() ? 0 : 1;
+        }
+        out.put(index);
+        out.put(mem->depth());
+        out.put(mem->data_width());
+        out.put(entries);
+        for (uint32_t addr = 0; addr < mem->depth(); ++addr) {
+            if (data[addr].is_zero())
+                continue;
+            out.put(addr);
+            out.put_words(data[addr]);
+        }
+        stored_entries += entries;
+    }
+
+    // JIT 的 data_buffer_ 以节点 id 为下标，同样换成 eval list 顺序
+    uint32_t jit_words = 0;
+#if __has_include("jit/jit_compiler.h")
+    if (jit_compiler_ && jit_compiler_->data_buffer_size() > 0)
+        jit_words = static_cast<uint32_t>(eval_list_.size());
+#endif
+    out.put(jit_words);
+#if __has_include("jit/jit_compiler.h")
+    for (uint32_t index = 0; index < jit_words; ++index) {
+        auto *node = eval_list_[index];
+        uint64_t word = 0;
+        if (node && node->id() < jit_compiler_->data_buffer_size())
+            word = jit_compiler_->data_buffer()[node->id()];
+        out.put(word);
+    }
+#endif
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        CHERROR("Cannot open checkpoint file '%s' for writing", path.c_str());
+        return false;
+    }
+    file.write(out.data().data(),
+               static_cast<std::streamsize>(out.data().size()));
+    if (!file) {
+        CHERROR("Failed to write checkpoint file '%s'", path.c_str());
+        return false;
+    }
+
+    CHINFO("Saved checkpoint '%s': %zu values, %zu memories (%zu non-zero "
+           "entries), %zu bytes",
+           path.c_str(), values.size(), memories.size(), stored_entries,
+           out.data().size());
+    return true;
+}
+
+bool Simulator::restore_checkpoint(const std::string &path) {
+    CHDBG_FUNC();
+
+    if (!initialized_ || disconnected_) {
+        CHERROR("Cannot restore a checkpoint into an uninitialized simulator");
+        return false;
+    }
+    if (backend_) {
+        CHERROR("Cannot restore while backend '%s' owns the design state",
+                backend_name_.c_str());
+        return false;
+    }
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        CHERROR("Cannot open checkpoint file '%s'", path.c_str());
+        return false;
+    }
+    const std::string buf((std::istreambuf_iterator<char>(file)),
+                          std::istreambuf_iterator<char>());
+
+    CheckpointImage image;
+    if (!parse_checkpoint(buf, image))
+        return false;
+
+    if (image.design_hash != design_hash()) {
+        CHERROR("Checkpoint '%s' was taken from a different design "
+                "(hash %016llx, current %016llx)",
+                path.c_str(), (unsigned long long)image.design_hash,
+                (unsigned long long)design_hash());
+        return false;
+    }
+
+    // 校验每一项都能落到当前仿真器上，之后的写入不会中途失败
+    auto value_of = [this](uint32_t index) -> ch::core::sdata_type * {
+        if (index >= eval_list_.size() || !eval_list_[index])
+            return nullptr;
+        auto it = data_map_.find(eval_list_[index]->id());
+        return it == data_map_.end() ? nullptr : &it->second;
+    };
+    auto instr_of = [this](uint32_t index) -> instr_base * {
+        if (index >= eval_list_.size() || !eval_list_[index])
+            return nullptr;
+        auto it = instr_map_.find(eval_list_[index]->id());
+        return it == instr_map_.end() ? nullptr : it->second;
+    };
+
+    for (const auto &value : image.values) {
+        auto *dst = value_of(value.id);
+        if (!dst || dst->bitwidth() != value.width) {
+            CHERROR("Checkpoint value for node #%u does not match the design",
+                    value.id);
+            return false;
+        }
+    }
+    for (const auto &memory : image.memories) {
+        auto *mem = dynamic_cast<instr_mem *>(instr_of(memory.id));
+        if (!mem || mem->depth() != memory.depth ||
+            mem->data_width() != memory.width) {
+            CHERROR("Checkpoint memory #%u does not match the design",
+                    memory.id);
+            return false;
+        }
+    }
+    if (image.domains.size() != clock_domains_.size()) {
+        CHERROR("Checkpoint has %zu clock domains, design has %zu",
+                image.domains.size(), clock_domains_.size());
+        return false;
+    }
+
+    for (const auto &value : image.values) {
+        load_words(*value_of(value.id), value.words.data());
+    }
+    for (const auto &clock : image.clocks) {
+        if (auto *instr = dynamic_cast<instr_clock *>(instr_of(clock.id)))
+            instr->restore_state(clock.last_clk, clock.posedge, clock.negedge);
+    }
+    for (const auto &port : image.ports) {
+        auto *instr = instr_of(port.id);
+        if (auto *rd = dynamic_cast<instr_mem_sync_read_port *>(instr))
+            rd->last_clk() = port.last_clk;
+        else if (auto *wr = dynamic_cast<instr_mem_write_port *>(instr))
+            wr->last_clk() = port.last_clk;
+    }
+    for (size_t i = 0; i < image.domains.size(); ++i) {
+        auto &domain = clock_domains_[i];
+        domain.period = image.domains[i].period;
+        domain.phase = image.domains[i].phase;
+        domain.next_edge = image.domains[i].next_edge;
+        domain.edge_count = image.domains[i].edge_count;
+    }
+    for (const auto &memory : image.memories) {
+        auto *mem = static_cast<instr_mem *>(instr_of(memory.id));
+        auto *data = mem->get_memory();
+        for (uint32_t addr = 0; addr < memory.depth; ++addr) {
+            data[addr].reset();
+        }
+        const uint32_t words = word_count(memory.width);
+        for (size_t e = 0; e < memory.addrs.size(); ++e) {
+            load_words(data[memory.addrs[e]], &memory.words[e * words]);
+        }
+    }
+
+#if __has_include("jit/jit_compiler.h")
+    if (jit_compiler_ && image.jit_buffer.size() == eval_list_.size()) {
+        for (uint32_t index = 0; index < eval_list_.size(); ++index) {
+            auto *node = eval_list_[index];
+            if (node && node->id() < jit_compiler_->data_buffer_size())
+                jit_compiler_->data_buffer()[node->id()] =
+                    image.jit_buffer[index];
+        }
+    }
+#endif
+
+    ticks_ = image.ticks;
+    sim_time_ = image.sim_time;
+    event_floor_ = image.event_floor;
+    multi_clock_ = image.multi_clock;
+    schedule_ready_ = image.schedule_ready;
+    skip_idle_domains_ = image.skip_idle;
+
+    CHINFO("Restored checkpoint '%s' at tick %llu", path.c_str(),
+           (unsigned long long)ticks_);
+    return true;
+}
+
+Simulator::Simulator(const Simulator &parent, fork_tag)
+    : ctx_(parent.ctx_), trace_on_(false) {
+    CHDBG_FUNC();
+
+    ctx_curr_backup_ = ch::core::ctx_curr_;
+    ch::core::ctx_curr_ = ctx_;
+
+    // initialize() 末尾按 num_threads_ 建立分区
+    num_threads_ = parent.num_threads_;
+    initialize();
+
+#if __has_include("jit/jit_compiler.h")
+    jit_enabled_ = parent.jit_enabled_;
+    ab_verification_ = parent.ab_verification_;
+    if (parent.jit_compiler_) {
+        // 共享已编译的代码，不再调用 try_jit_compile()
+        jit_compiler_ = parent.jit_compiler_->clone();
+        jit_compiled_ = parent.jit_compiled_;
+    }
+#endif
+
+    copy_state_from(parent);
+}
+
+std::unique_ptr<Simulator> Simulator::fork() const {
+    CHDBG_FUNC();
+
+    if (!initialized_ || disconnected_) {
+        CHERROR("Cannot fork an uninitialized simulator");
+        return nullptr;
+    }
+    if (backend_) {
+        CHERROR("Cannot fork while backend '%s' owns the design state",
+                backend_name_.c_str());
+        return nullptr;
+    }
+    return std::unique_ptr<Simulator>(new Simulator(*this, fork_tag{}));
+}
+
+void Simulator::copy_state_from(const Simulator &parent) {
+    CHDBG_FUNC();
+
+    // 同一个 context 生成的 data_map_ 键集合与位宽完全相同；逐项赋值，
+    // 不改变各缓冲区地址（指令对象持有这些指针）
+    for (auto &[id, value] : data_map_) {
+        auto it = parent.data_map_.find(id);
+        if (it != parent.data_map_.end())
+            value = it->second;
+    }
+
+    for (auto &[id, instr] : instr_map_) {
+        auto parent_it = parent.instr_map_.find(id);
+        if (parent_it == parent.instr_map_.end())
+            continue;
+        auto *source = parent_it->second;
+        if (auto *clock = dynamic_cast<instr_clock *>(instr)) {
+            auto *src = static_cast<const instr_clock *>(source);
+            clock->restore_state(src->last_clock_value(),
+                                 src->is_posedge_active(),
+                                 src->is_negedge_active());
+        } else if (auto *mem = dynamic_cast<instr_mem *>(instr)) {
+            mem->share_memory(*static_cast<const instr_mem *>(source));
+        } else if (auto *rd = dynamic_cast<instr_mem_sync_read_port *>(instr)) {
+            rd->last_clk() =
+                static_cast<const instr_mem_sync_read_port *>(source)
+                    ->last_clk();
+        } else if (auto *wr = dynamic_cast<instr_mem_write_port *>(instr)) {
+            wr->last_clk() =
+                static_cast<const instr_mem_write_port *>(source)->last_clk();
+        }
+    }
+
+    for (size_t i = 0;
+         i < clock_domains_.size() && i < parent.clock_domains_.size(); ++i) {
+        clock_domains_[i].period = parent.clock_domains_[i].period;
+        clock_domains_[i].phase = parent.clock_domains_[i].phase;
+        clock_domains_[i].next_edge = parent.clock_domains_[i].next_edge;
+        clock_domains_[i].edge_count = parent.clock_domains_[i].edge_count;
+    }
+
+    ticks_ = parent.ticks_;
+    sim_time_ = parent.sim_time_;
+    event_floor_ = parent.event_floor_;
+    multi_clock_ = parent.multi_clock_;
+    schedule_ready_ = parent.schedule_ready_;
+    skip_idle_domains_ = parent.skip_idle_domains_;
+}
+
+} // namespace ch
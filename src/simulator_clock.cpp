@@ -0,0 +1,330 @@
+// src/simulator_clock.cpp
+// ADR-036: multi-clock-domain scheduling.
+// Owns: classify_clock_domains, set_clock_period, clock_edge_count,
+//       prepare_clock_schedule, step_clock_edge, eval_sequential_domains,
+//       run_for.
+//
+// 每个时钟域记录 period/phase 与下一个沿的时刻。一次 step 取所有域中最早的
+// 沿时刻，只把这些域的时钟置 1 并求值它们的时序指令（JIT 下调用对应的
+// tick_seq_<domain>），空闲域的寄存器/存储器端口完全不参与。
+#include "simulator.h"
+#include "ast/ast_nodes.h"
+#include "ast/mem_port_impl.h"
+#include "core/lnodeimpl.h"
+#include "logger.h"
+#include "types.h"
+#include <algorithm>
+#include <limits>
+
+namespace ch {
+
+void Simulator::classify_clock_domains() {
+    CHDBG_FUNC();
+
+    // reinitialize() 时保留已配置的周期/相位
+    std::unordered_map<uint32_t, std::pair<uint64_t, uint64_t>> saved;
+    for (const auto &domain : clock_domains_) {
+        saved[domain.clock_id] = {domain.period, domain.phase};
+    }
+
+    clock_domains_.clear();
+    clock_domain_index_.clear();
+    schedule_ready_ = false;
+
+    auto add_domain = [&](uint32_t clock_id, const std::string &name) {
+        ClockDomain domain;
+        domain.clock_id = clock_id;
+        domain.name = name;
+        auto data_it = data_map_.find(clock_id);
+        if (data_it != data_map_.end()) {
+            domain.clock_data = &data_it->second;
+        }
+        auto saved_it = saved.find(clock_id);
+        if (saved_it != saved.end()) {
+            domain.period = saved_it->second.first;
+            domain.phase = saved_it->second.second;
+        }
+        clock_domain_index_[clock_id] = clock_domains_.size();
+        clock_domains_.push_back(std::move(domain));
+    };
+
+    // 默认时钟域固定在下标 0；时钟节点不在 eval list 中的时序节点也归入该域，
+    // 与 JitCompiler::generate_ir 的划分规则一致
+    if (ctx_->has_default_clock()) {
+        add_domain(ctx_->get_default_clock()->id(),
+                   ctx_->get_default_clock()->name());
+    } else {
+        add_domain(static_cast<uint32_t>(-1), "default_clock");
+    }
+
+    for (auto *node : eval_list_) {
+        if (node && node->type() == ch::core::lnodetype::type_clock &&
+            !clock_domain_index_.count(node->id())) {
+            add_domain(node->id(), node->name());
+        }
+    }
+
+    for (auto *node : eval_list_) {
+        if (!node)
+            continue;
+
+        auto instr_it = instr_map_.find(node->id());
+        if (instr_it == instr_map_.end())
+            continue;
+
+        uint32_t clock_id = static_cast<uint32_t>(-1);
+        switch (node->type()) {
+        case ch::core::lnodetype::type_reg:
+            clock_id = static_cast<ch::core::regimpl *>(node)->cd();
+            break;
+        case ch::core::lnodetype::type_mem_read_port:
+        case ch::core::lnodetype::type_mem_write_port:
+            if (auto *cd = static_cast<ch::core::mem_port_impl *>(node)->cd()) {
+                clock_id = cd->id();
+            } else {
+                // 异步读端口不属于任何时钟域：任一域有沿都刷新一次
+                for (auto &domain : clock_domains_) {
+                    domain.seq_instrs.emplace_back(node->id(),
+                                                   instr_it->second);
+                }
+                continue;
+            }
+            break;
+        default:
+            continue;
+        }
+
+        auto domain_it = clock_domain_index_.find(clock_id);
+        size_t index =
+            domain_it != clock_domain_index_.end() ? domain_it->second : 0;
+        clock_domains_[index].seq_instrs.emplace_back(node->id(),
+                                                      instr_it->second);
+    }
+
+    CHDBG("Classified %zu clock domains", clock_domains_.size());
+}
+
+bool Simulator::set_clock_period(const std::string &clock_name,
+                                 uint64_t period, uint64_t phase) {
+    CHDBG_FUNC();
+
+    if (period == 0) {
+        CHERROR("Clock period for '%s' must be non-zero", clock_name.c_str());
+        return false;
+    }
+
+    for (auto &domain : clock_domains_) {
+        if (domain.name == clock_name) {
+            domain.period = period;
+            domain.phase = phase;
+            multi_clock_ = true;
+            schedule_ready_ = false;
+            return true;
+        }
+    }
+
+    CHERROR("Clock '%s' is not part of the simulated design",
+            clock_name.c_str());
+    return false;
+}
+
+bool Simulator::set_clock_period(const ch::core::clockimpl *clk,
+                                 uint64_t period, uint64_t phase) {
+    if (!clk) {
+        CHERROR("Cannot set period of a null clock");
+        return false;
+    }
+
+    auto it = clock_domain_index_.find(clk->id());
+    if (it == clock_domain_index_.end()) {
+        CHERROR("Clock node %u is not part of the simulated design",
+                clk->id());
+        return false;
+    }
+    if (period == 0) {
+        CHERROR("Clock period for node %u must be non-zero", clk->id());
+        return false;
+    }
+
+    auto &domain = clock_domains_[it->second];
+    domain.period = period;
+    domain.phase = phase;
+    multi_clock_ = true;
+    schedule_ready_ = false;
+    return true;
+}
+
+uint64_t Simulator::clock_edge_count(const std::string &clock_name) const {
+    for (const auto &domain : clock_domains_) {
+        if (domain.name == clock_name) {
+            return domain.edge_count;
+        }
+    }
+    return 0;
+}
+
+void Simulator::prepare_clock_schedule() {
+    CHDBG_FUNC();
+
+    uint64_t default_period =
+        clock_domains_.empty() || clock_domains_[0].period == 0
+            ? 1
+            : clock_domains_[0].period;
+
+    // 每个域的下一个沿：phase + k * period 中第一个不早于 event_floor_ 的
+    for (auto &domain : clock_domains_) {
+        if (domain.period == 0) {
+            domain.period = default_period;
+        }
+        domain.next_edge = domain.phase;
+        if (domain.next_edge < event_floor_) {
+            uint64_t k = (event_floor_ - domain.phase + domain.period - 1) /
+                         domain.period;
+            domain.next_edge = domain.phase + k * domain.period;
+        }
+    }
+    schedule_ready_ = true;
+}
+
+void Simulator::eval_sequential_domains(const std::vector<size_t> &domains) {
+    CHDBG_FUNC();
+
+    if (backend_) {
+        // ADR-035: 有沿的域时钟已置 1，后端（Verilator 从 data_map 同步
+        // 时钟端口）自行只触发这些域
+        backend_->eval_sequential(data_map_, sequential_instr_list_);
+        return;
+    }
+
+#if __has_include("jit/jit_compiler.h")
+    // JIT 时序函数不检查时钟值，必须只调用有沿的域
+    if (jit_enabled_ && jit_compiled_ && jit_compiler_ &&
+        jit_compiler_->has_seq_func()) {
+        for (size_t index : domains) {
+            for (const auto &[node_id, instr] :
+                 clock_domains_[index].seq_instrs) {
+                if (jit_compiler_->is_external_node(node_id)) {
+                    instr->eval();
+                }
+            }
+        }
+
+        jit_compiler_->sync_to_buffer(data_map_);
+        for (size_t index : domains) {
+            jit_compiler_->execute_seq_tick(clock_domains_[index].clock_id);
+        }
+        jit_compiler_->sync_from_buffer(data_map_);
+        return;
+    }
+#endif
+
+    if (partitioned_eval_) {
+        // 分区求值器并行执行全部时序指令，空闲域的寄存器因时钟为 0 不更新
+        partitioned_eval_->eval_sequential();
+        return;
+    }
+
+    if (!skip_idle_domains_) {
+        // 对照路径：全部时序指令都执行，空闲域的寄存器因时钟为 0 不更新
+        for (const auto &[node_id, instr] : sequential_instr_list_) {
+            instr->eval();
+        }
+        return;
+    }
+
+    for (size_t index : domains) {
+        for (const auto &[node_id, instr] : clock_domains_[index].seq_instrs) {
+            instr->eval();
+            CHDBG("Evaluating sequential instruction for node %u in domain "
+                  "'%s'",
+                  node_id, clock_domains_[index].name.c_str());
+        }
+    }
+}
+
+void Simulator::step_clock_edge() {
+    CHDBG_FUNC();
+
+    if (!schedule_ready_) {
+        prepare_clock_schedule();
+    }
+
+    uint64_t t = std::numeric_limits<uint64_t>::max();
+    for (const auto &domain : clock_domains_) {
+        t = std::min(t, domain.next_edge);
+    }
+
+    edge_domains_.clear();
+    for (size_t i = 0; i < clock_domains_.size(); ++i) {
+        if (clock_domains_[i].next_edge == t) {
+            edge_domains_.push_back(i);
+        }
+    }
+
+    sim_time_ = t;
+    event_floor_ = t + 1;
+
+    eval_combinational();
+
+    for (size_t index : edge_domains_) {
+        if (auto *clock_data = clock_domains_[index].clock_data) {
+            *clock_data = ch::core::sdata_type(1, 1);
+        }
+    }
+
+    eval_sequential_domains(edge_domains_);
+
+    for (size_t index : edge_domains_) {
+        auto &domain = clock_domains_[index];
+        if (domain.clock_data) {
+            *domain.clock_data = ch::core::sdata_type(0, 1);
+        }
+        domain.next_edge += domain.period;
+        ++domain.edge_count;
+    }
+
+    eval_combinational();
+
+    if (trace_on_) {
+        trace();
+    }
+}
+
+void Simulator::run_for(uint64_t duration) {
+    CHDBG_FUNC();
+
+    if (!initialized_ || disconnected_ || !ctx_) {
+        CHERROR("Simulator not initialized or disconnected");
+        return;
+    }
+
+    if (!multi_clock_) {
+        CHWARN("run_for() without set_clock_period(): treating duration as "
+               "%llu single-clock ticks",
+               (unsigned long long)duration);
+        tick(static_cast<size_t>(duration));
+        return;
+    }
+
+    if (!schedule_ready_) {
+        prepare_clock_schedule();
+    }
+
+    // 处理 [event_floor_, event_floor_ + duration) 内的全部沿
+    uint64_t end = event_floor_ + duration;
+    for (;;) {
+        uint64_t next = std::numeric_limits<uint64_t>::max();
+        for (const auto &domain : clock_domains_) {
+            next = std::min(next, domain.next_edge);
+        }
+        if (next >= end)
+            break;
+        ++ticks_;
+        step_clock_edge();
+    }
+
+    sim_time_ = end;
+    event_floor_ = end;
+}
+
+} // namespace ch
@@ -2,7 +2,7 @@
 // Phase 6: Simulator::initialize() moved out of simulator.cpp.
 // Owns: Simulator::initialize() — context setup, data buffer allocation,
 //       instruction creation + classification (input/reset/clock/seq/comb),
-//       memory port wiring.
+//       memory port wiring, per-clock-domain grouping (ADR-036).
 #include "simulator.h"
 #include "ast/ast_nodes.h"
 #include "ast/instr_mem.h"
@@ -202,6 +202,17 @@ void Simulator::initialize() {
         }
     }
 
+    // ADR-036: 按时钟域分组时序指令（多时钟调度使用）
+    classify_clock_domains();
+
+    // ADR-037: 指令对象已重建，分区也需要重建
+    if (num_threads_ > 0) {
+        build_partitions();
+    }
+
+    // ADR-040: data_map_ 重建后 watch 的缓冲区指针失效
+    resolve_watches();
+
     initialized_ = true;
     CHINFO("Simulator initialization completed successfully");
 }
@@ -0,0 +1,48 @@
+// src/simulator_parallel.cpp
+// ADR-037: multi-threaded partitioned evaluation.
+// Owns: set_num_threads, build_partitions.
+//
+// 分区与线程池由 PartitionedEvaluator 持有；Simulator 只负责在指令对象
+// （重新）创建后重建分区，并在解释器路径上把 comb / seq 阶段交给它。
+#include "simulator.h"
+#include "logger.h"
+
+namespace ch {
+
+void Simulator::set_num_threads(unsigned threads) {
+    CHDBG_FUNC();
+
+    if (threads == num_threads_ && (threads == 0 || partitioned_eval_)) {
+        return;
+    }
+
+    num_threads_ = threads;
+    partitioned_eval_.reset();
+    if (threads == 0) {
+        CHINFO("Partitioned evaluation disabled");
+        return;
+    }
+
+    if (initialized_ && !disconnected_) {
+        build_partitions();
+    }
+
+#if __has_include("jit/jit_compiler.h")
+    if (jit_enabled_ && jit_compiled_) {
+        CHINFO("JIT is active: partitioned evaluation only applies after "
+               "set_jit_enabled(false)");
+    }
+#endif
+}
+
+void Simulator::build_partitions() {
+    CHDBG_FUNC();
+
+    if (!partitioned_eval_ || partitioned_eval_->threads() != num_threads_) {
+        partitioned_eval_ = std::make_unique<PartitionedEvaluator>(num_threads_);
+    }
+    partitioned_eval_->build(eval_list_, combinational_instr_list_,
+                             sequential_instr_list_);
+}
+
+} // namespace ch
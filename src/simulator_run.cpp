@@ -0,0 +1,295 @@
+// src/simulator_run.cpp
+// ADR-040: condition-driven stepping inside the engine.
+// Owns: watch_equals/not_equals/changed, on_change, run_until, run_ticks.
+//
+// 停止条件与回调登记为 watch，直接持有 data_map_ 中节点缓冲区的指针
+// （data_map_ 建好后不再插入，指针稳定；initialize() 重建时重新解析）。
+// run_until() 逐拍调用 step() 并比较这些缓冲区，测试台不再每拍经过
+// tick() 的进度计时与 get_port_value() 的哈希查找。
+#include "simulator.h"
+#include "core/lnodeimpl.h"
+#include "logger.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace ch {
+
+namespace {
+
+// 进度报告读一次时钟，条件推进循环里每 64K 拍才检查一次
+constexpr uint64_t kProgressInterval = 1u << 16;
+
+uint64_t low_word(const ch::core::sdata_type &data) {
+    return data.bitvector().num_words() > 0 ? data.bitvector().words()[0] : 0;
+}
+
+void snapshot(const ch::core::sdata_type &data, std::vector<uint64_t> &out) {
+    const auto &bv = data.bitvector();
+    out.assign(bv.words(), bv.words() + bv.num_words());
+}
+
+bool same_words(const ch::core::sdata_type &data,
+                const std::vector<uint64_t> &last) {
+    const auto &bv = data.bitvector();
+    return bv.num_words() == last.size() &&
+           std::memcmp(bv.words(), last.data(),
+                       last.size() * sizeof(uint64_t)) == 0;
+}
+
+} // namespace
+
+Simulator::watch_id
+Simulator::add_watch(ch::core::lnodeimpl *node, WatchKind kind, uint64_t value,
+                     std::function<void(uint64_t)> callback) {
+    if (!node) {
+        CHERROR("watch: signal implementation is null");
+        return -1;
+    }
+    auto it = data_map_.find(node->id());
+    if (it == data_map_.end()) {
+        CHERROR("watch: node %u has no simulation value", node->id());
+        return -1;
+    }
+    if (kind == WatchKind::callback && !callback) {
+        CHERROR("watch: on_change() requires a callback");
+        return -1;
+    }
+
+    Watch w;
+    w.id = next_watch_id_++;
+    w.kind = kind;
+    w.node_id = node->id();
+    w.data = &it->second;
+    w.value = value;
+    w.callback = std::move(callback);
+    snapshot(*w.data, w.last);
+    if (kind == WatchKind::callback) {
+        ++callback_watches_;
+    }
+    watches_.push_back(std::move(w));
+    return watches_.back().id;
+}
+
+bool Simulator::remove_watch(watch_id id) {
+    auto it = std::find_if(watches_.begin(), watches_.end(),
+                           [id](const Watch &w) { return w.id == id; });
+    if (it == watches_.end()) {
+        return false;
+    }
+    if (it->kind == WatchKind::callback) {
+        --callback_watches_;
+    }
+    watches_.erase(it);
+    return true;
+}
+
+void Simulator::clear_watches() {
+    watches_.clear();
+    callback_watches_ = 0;
+    last_stop_watch_ = -1;
+}
+
+void Simulator::resolve_watches() {
+    for (auto &w : watches_) {
+        auto it = data_map_.find(w.node_id);
+        w.data = it != data_map_.end() ? &it->second : nullptr;
+        if (w.data) {
+            snapshot(*w.data, w.last);
+        }
+    }
+}
+
+// 回调总是触发；stop_enabled 时按登记顺序返回第一个命中的停止条件
+bool Simulator::check_watches(bool stop_enabled) {
+    bool stop = false;
+    for (auto &w : watches_) {
+        if (!w.data) {
+            continue;
+        }
+        switch (w.kind) {
+        case WatchKind::equals:
+            if (stop_enabled && !stop && low_word(*w.data) == w.value) {
+                last_stop_watch_ = w.id;
+                stop = true;
+            }
+            break;
+        case WatchKind::not_equals:
+            if (stop_enabled && !stop && low_word(*w.data) != w.value) {
+                last_stop_watch_ = w.id;
+                stop = true;
+            }
+            break;
+        case WatchKind::changed:
+            if (stop_enabled && !stop && !same_words(*w.data, w.last)) {
+                snapshot(*w.data, w.last);
+                last_stop_watch_ = w.id;
+                stop = true;
+            }
+            break;
+        case WatchKind::callback:
+            if (!same_words(*w.data, w.last)) {
+                snapshot(*w.data, w.last);
+                w.callback(low_word(*w.data));
+            }
+            break;
+        }
+    }
+    return stop;
+}
+
+uint64_t Simulator::run_ticks(uint64_t max_ticks, bool stop_enabled,
+                              const std::function<bool()> *predicate) {
+    if (!initialized_ || disconnected_ || !ctx_) {
+        CHERROR("Simulator not initialized or disconnected");
+        return 0;
+    }
+
+    if (stop_enabled) {
+        last_stop_watch_ = -1;
+        for (auto &w : watches_) {
+            if (w.kind == WatchKind::changed && w.data) {
+                snapshot(*w.data, w.last);
+            }
+        }
+    }
+    const bool check = (stop_enabled && !watches_.empty()) ||
+                       callback_watches_ > 0;
+
+    // 精简循环：单时钟、无外部后端、无跟踪、无回调/predicate（它们可能在
+    // 拍间改写输入）时，两拍之间没有任何东西会改变组合逻辑的输入，tick()
+    // 开头和结尾那两次重复的组合求值可以省掉
+    bool lean = !multi_clock_ && !backend_ && !trace_on_ && !predicate &&
+                callback_watches_ == 0 && default_clock_instr_ &&
+                other_clock_instr_list_.empty();
+#if __has_include("jit/jit_compiler.h")
+    if (lean && jit_enabled_ && jit_compiled_ && jit_compiler_) {
+        const bool jit_lean =
+            jit_compiler_->has_comb_func() && jit_compiler_->has_seq_func() &&
+            !jit_compiler_->has_external_nodes() &&
+            std::all_of(watches_.begin(), watches_.end(), [&](const Watch &w) {
+                return w.node_id < jit_compiler_->data_buffer_size() &&
+                       w.data && w.data->bitwidth() <= 64;
+            });
+        if (jit_lean) {
+            return run_ticks_jit(max_ticks, stop_enabled);
+        }
+        // 有解释器回退节点时 tick() 还要补算它们，走完整的 step()
+        lean = false;
+    }
+#endif
+
+    uint64_t done = 0;
+    if (lean) {
+        // 一拍 = 时钟 0->1（时序）+ 1->0（组合），与 tick() 的状态转移相同
+        eval_combinational();
+        while (done < max_ticks) {
+            ++ticks_;
+            ++done;
+            if ((ticks_ & (kProgressInterval - 1)) == 0) {
+                report_progress();
+            }
+            eval();
+            eval();
+            if (check && check_watches(stop_enabled)) {
+                break;
+            }
+        }
+        return done;
+    }
+
+    while (done < max_ticks) {
+        ++ticks_;
+        ++done;
+        if ((ticks_ & (kProgressInterval - 1)) == 0) {
+            report_progress();
+        }
+        step();
+        if (check && check_watches(stop_enabled)) {
+            break;
+        }
+        if (predicate && (*predicate)()) {
+            break;
+        }
+        if (disconnected_) {
+            break;
+        }
+    }
+    return done;
+}
+
+#if __has_include("jit/jit_compiler.h")
+// JIT 精简循环：整段只同步一次 data_map_。每拍依次调用 tick_seq / tick_comb，
+// watch 直接读 data_buffer_（JIT 只编译 64 位以内的节点，每节点一个字）；
+// 时钟保持为 0，结束时与 tick() 之后的状态一致。
+uint64_t Simulator::run_ticks_jit(uint64_t max_ticks, bool stop_enabled) {
+    const uint64_t *buffer = jit_compiler_->data_buffer();
+    jit_compiler_->sync_to_buffer(data_map_);
+    jit_compiler_->execute_comb_tick();
+
+    uint64_t done = 0;
+    while (done < max_ticks) {
+        ++ticks_;
+        ++done;
+        if ((ticks_ & (kProgressInterval - 1)) == 0) {
+            report_progress();
+        }
+        jit_compiler_->execute_seq_tick();
+        jit_compiler_->execute_comb_tick();
+        if (!stop_enabled) {
+            continue;
+        }
+        bool stop = false;
+        for (auto &w : watches_) {
+            const uint64_t v = buffer[w.node_id];
+            switch (w.kind) {
+            case WatchKind::equals:
+                stop = v == w.value;
+                break;
+            case WatchKind::not_equals:
+                stop = v != w.value;
+                break;
+            case WatchKind::changed:
+                stop = w.last.empty() || v != w.last[0];
+                break;
+            case WatchKind::callback:
+                break;
+            }
+            if (stop) {
+                last_stop_watch_ = w.id;
+                break;
+            }
+        }
+        if (stop) {
+            break;
+        }
+    }
+
+    jit_compiler_->sync_from_buffer(data_map_);
+    for (auto &w : watches_) {
+        if (w.kind == WatchKind::changed && w.data) {
+            snapshot(*w.data, w.last);
+        }
+    }
+    return done;
+}
+#endif
+
+uint64_t Simulator::run_until(uint64_t max_ticks) {
+    CHDBG_FUNC();
+    if (std::none_of(watches_.begin(), watches_.end(), [](const Watch &w) {
+            return w.kind != WatchKind::callback;
+        })) {
+        CHWARN("run_until() without stop watches runs all %llu ticks",
+               static_cast<unsigned long long>(max_ticks));
+    }
+    return run_ticks(max_ticks, true, nullptr);
+}
+
+uint64_t Simulator::run_until(const std::function<bool()> &predicate,
+                              uint64_t max_ticks) {
+    CHDBG_FUNC();
+    return run_ticks(max_ticks, true, predicate ? &predicate : nullptr);
+}
+
+} // namespace ch
@@ -0,0 +1,12 @@
+// tests/benchmark/log_gate_compiled_in.cpp
+// 所有级别都编译进来，由运行期级别关闭
+#undef CH_LOG_MIN_LEVEL
+#define CH_LOG_MIN_LEVEL 0
+#define LOG_GATE_NS log_gate_compiled_in
+#include "log_gate_kernel.inc"
+
+namespace log_gate_compiled_in {
+uint64_t run(unsigned nodes, unsigned ticks) {
+    return run_tick_loop(nodes, ticks);
+}
+} // namespace log_gate_compiled_in
@@ -0,0 +1,12 @@
+// tests/benchmark/log_gate_removed.cpp
+// 所有级别在编译期关闭：与删除日志调用等价的基线
+#undef CH_LOG_MIN_LEVEL
+#define CH_LOG_MIN_LEVEL 5
+#define LOG_GATE_NS log_gate_removed
+#include "log_gate_kernel.inc"
+
+namespace log_gate_removed {
+uint64_t run(unsigned nodes, unsigned ticks) {
+    return run_tick_loop(nodes, ticks);
+}
+} // namespace log_gate_removed
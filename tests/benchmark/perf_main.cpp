@@ -3,18 +3,20 @@
  * @brief Main entry point for CppHDL performance benchmarks.
  *
  * Legacy TC-01/02/04/06 use a single backend. TC-07/08 do three-way
- * comparison (Interpreter / JIT / Verilator); the Verilator path
- * gracefully degrades to 2-way when verilator is not installed.
+ * comparison (Interpreter / JIT / Verilator); all three run in-process
+ * through ch::Simulator (Verilator via set_backend(VerilatorBackend)),
+ * and the Verilator path gracefully degrades to 2-way when verilator is
+ * not installed.
  */
 
 #include "perf_timer.h"
 #include "stats_collector.h"
 #include "report_generator.h"
-#include "verilator_runner.h"
 #include "subprocess_runner.h"
 #include "ch.hpp"
 #include "simulator.h"
 #include "codegen_verilog.h"
+#include "core/verilator_backend.h"
 #include "device.h"
 #include "component.h"
 #include "core/io.h"
@@ -427,7 +429,6 @@ static ThreeWayResult run_three_way(const std::string& test_name,
                                     const std::string& params,
                                     int ticks, int warmup, int measured,
                                     const std::string& verilog_path,
-                                    const std::string& harness_path,
                                     const std::string& verilator_bin,
                                     const std::string& cache_root,
                                     const std::string& workdir,
@@ -469,41 +470,44 @@ static ThreeWayResult run_three_way(const std::string& test_name,
         twr.jit = make_row(test_name, params, "jit",
                            build_us_measured, mu, measured, mu, "PASS");
     }
-    // Verilator backend — skipped gracefully when unavailable.
-    ch_perf::VerilatorRunner vr(cache_root, verilator_bin);
-    if (!vr.is_available()) {
+    // Verilator backend — in-process through Simulator::set_backend()
+    // (ADR-035 Phase 3.7), so the timed loop is the same tick(ticks)
+    // as the other two rows instead of an external harness process.
+    // Skipped gracefully when verilator is unavailable.
+    if (VerilatorBackend::detect_verilator_version(verilator_bin).empty()) {
         // W5 (perf-report-followup.md): UNSUPPORTED = environment missing
         // (verilator binary not on PATH), distinct from SKIPPED = runtime
-        // hiccup (compile error, missing harness).
+        // hiccup (compile error, unbindable port names).
         twr.verilator_skipped = true;
         twr.skip_reason = "verilator not found on PATH";
         twr.verilator = make_row(test_name, params, "verilator",
                                  0.0, 0.0, 0, 0.0, "UNSUPPORTED");
         twr.verilator.skip_reason = twr.skip_reason;
-    } else if (!std::filesystem::exists(verilog_path) ||
-               !std::filesystem::exists(harness_path)) {
-        twr.verilator_skipped = true;
-        twr.skip_reason = "verilog or harness file missing";
-        twr.verilator = make_row(test_name, params, "verilator",
-                                 0.0, 0.0, 0, 0.0, "SKIPPED");
-        twr.verilator.skip_reason = twr.skip_reason;
     } else {
-        auto br = vr.build(test_name, verilog_path, harness_path);
-        if (!br.success) {
+        std::string vl_dir = workdir + "/" + test_name + "_" + params;
+        std::filesystem::create_directories(vl_dir, ec);
+        ch_device<DutT, CtorArgs...> dev(std::forward<CtorArgs>(ctor_args)...);
+        Simulator s(dev.context());
+        auto backend = std::make_unique<VerilatorBackend>(vl_dir, verilator_bin);
+        backend->set_cache_root(cache_root);
+        auto *vl = backend.get();
+        PerfTimer build_timer;
+        build_timer.start();
+        s.set_backend(std::move(backend));
+        build_timer.stop();
+        if (!vl->model_loaded()) {
             twr.verilator_skipped = true;
-            twr.skip_reason = br.error_msg;
+            twr.skip_reason = "Verilated model not loaded (see " + vl_dir + ")";
             twr.verilator = make_row(test_name, params, "verilator",
-                                     br.build_time_ns / 1000.0, 0.0,
+                                     build_timer.elapsed_us(), 0.0,
                                      0, 0.0, "SKIPPED");
             twr.verilator.skip_reason = twr.skip_reason;
         } else {
-            double bu = br.build_time_ns / 1000.0;
-            double mu = time_backend_us([&](){
-                std::string err;
-                vr.run_and_time(br.binary_path, ticks, &err);
-            }, warmup, measured);
+            s.tick(1);
+            double mu = time_backend_us([&](){ s.tick(ticks); }, warmup, measured);
             twr.verilator = make_row(test_name, params, "verilator",
-                                     bu, mu, measured, mu, "PASS");
+                                     build_timer.elapsed_us(), mu, measured,
+                                     mu, "PASS");
         }
     }
     if (twr.verilator_skipped && twr.verilator.status != "UNSUPPORTED" &&
@@ -522,7 +526,7 @@ static ThreeWayResult run_three_way_tc07(int depth, int ticks, int warmup,
                                          const std::string& wd) {
     return run_three_way<Tc07XorChain>(
         "TC-07", "depth=" + std::to_string(depth), ticks, warmup, measured,
-        wd + "/tc07_top.v", "build/tests/benchmark/verilator_harness_tc07.cpp",
+        wd + "/tc07_top.v",
         vb, cr, wd, depth);
 }
 
@@ -533,13 +537,13 @@ static ThreeWayResult run_three_way_tc08(int regs, int ticks, int warmup,
                                          const std::string& wd) {
     return run_three_way<Tc08RegChain>(
         "TC-08", "regs=" + std::to_string(regs), ticks, warmup, measured,
-        wd + "/tc08_top.v", "build/tests/benchmark/verilator_harness_tc08.cpp",
+        wd + "/tc08_top.v",
         vb, cr, wd, regs);
 }
 
-// W8 (perf-report-followup.md): TC-09 arith chain. Verilator not wired
-// (no harness) so emit SKIPPED for the verilator backend; interpreter/JIT
-// are exercised.
+// W8 (perf-report-followup.md): TC-09 arith chain. Like every
+// run_three_way() TC, the Verilator row runs in-process through
+// VerilatorBackend.
 static ThreeWayResult run_three_way_tc09(int depth, int ticks, int warmup,
                                          int measured,
                                          const std::string& vb,
@@ -547,7 +551,7 @@ static ThreeWayResult run_three_way_tc09(int depth, int ticks, int warmup,
                                          const std::string& wd) {
     return run_three_way<Tc09ArithChain>(
         "TC-09", "depth=" + std::to_string(depth), ticks, warmup, measured,
-        wd + "/tc09_top.v", "build/tests/benchmark/verilator_harness_tc09.cpp",
+        wd + "/tc09_top.v",
         vb, cr, wd, depth);
 }
 
@@ -579,7 +583,7 @@ static ThreeWayResult run_three_way_tc11(int regs, int ticks, int warmup,
                                          const std::string& wd) {
     return run_three_way<Tc11WideReg>(
         "TC-11", "regs=" + std::to_string(regs), ticks, warmup, measured,
-        wd + "/tc11_top.v", "build/tests/benchmark/verilator_harness_tc11.cpp",
+        wd + "/tc11_top.v",
         vb, cr, wd, regs);
 }
 
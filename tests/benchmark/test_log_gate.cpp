@@ -0,0 +1,74 @@
+/**
+ * @file test_log_gate.cpp
+ * @brief ADR-039: logging compiled in but disabled must cost nothing.
+ *
+ * The same tick-loop kernel (log_gate_kernel.inc — per-node eval plus the
+ * CHDBG call with to_string_verbose() arguments that Simulator uses) is
+ * compiled twice:
+ *   - log_gate_compiled_in.cpp: CH_LOG_MIN_LEVEL=0, runtime level set to
+ *     warning, so every call is present and rejected by the runtime check;
+ *   - log_gate_removed.cpp: CH_LOG_MIN_LEVEL=5, every call compiled out.
+ *
+ * Runs are interleaved and the minimum of several repetitions is compared,
+ * which keeps scheduler noise on a shared CI box out of the ratio. The gate
+ * allows 10%: the disabled path is one relaxed load and a branch per call
+ * and must never evaluate the arguments.
+ *
+ * Tag: [perf][logger] — runs under ctest -L perf.
+ */
+
+#include "catch_amalgamated.hpp"
+#include "perf_timer.h"
+#include "logger.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+
+namespace log_gate_compiled_in {
+uint64_t run(unsigned nodes, unsigned ticks);
+}
+namespace log_gate_removed {
+uint64_t run(unsigned nodes, unsigned ticks);
+}
+
+TEST_CASE("Log gate: disabled logging matches compiled-out logging",
+          "[perf][logger]") {
+    constexpr unsigned kNodes = 2000;
+    constexpr unsigned kTicks = 1000;
+    constexpr int kReps = 7;
+
+    const auto saved = ch::get_log_level();
+    ch::set_log_level(ch::log_level::warning);
+
+    // 预热并确认两个版本计算结果相同
+    const uint64_t a = log_gate_compiled_in::run(kNodes, 10);
+    const uint64_t b = log_gate_removed::run(kNodes, 10);
+    REQUIRE(a == b);
+
+    double best_in = std::numeric_limits<double>::max();
+    double best_removed = std::numeric_limits<double>::max();
+    uint64_t sink = 0;
+    for (int rep = 0; rep < kReps; ++rep) {
+        PerfTimer t;
+        t.start();
+        sink += log_gate_compiled_in::run(kNodes, kTicks);
+        t.stop();
+        best_in = std::min(best_in, t.elapsed_ms());
+
+        t.reset();
+        t.start();
+        sink += log_gate_removed::run(kNodes, kTicks);
+        t.stop();
+        best_removed = std::min(best_removed, t.elapsed_ms());
+    }
+    ch::set_log_level(saved);
+
+    const double ratio = best_in / best_removed;
+    std::cout << "[log-gate] nodes=" << kNodes << " ticks=" << kTicks
+              << " compiled_in_disabled=" << best_in
+              << "ms removed=" << best_removed << "ms ratio=" << ratio
+              << " (checksum " << (sink & 0xffff) << ")" << std::endl;
+    REQUIRE(ratio <= 1.10);
+}
@@ -0,0 +1,129 @@
+/**
+ * @file test_multi_clock_perf.cpp
+ * @brief ADR-036: 3-domain benchmark for skipping idle clock domains.
+ *
+ * Three clock domains (core / bus / periph, periods 1 / 2 / 8), each holding
+ * REGS free-running registers. The same run_for() window is simulated twice
+ * on the interpreter path:
+ *   - baseline: set_skip_idle_domains(false) — every edge event evaluates the
+ *     whole sequential list and idle-domain registers bail out on clk == 0
+ *     (what the single-clock scheduler does for every tick);
+ *   - scheduled: only the domains with an edge at the event time run.
+ * Per 8 time units the domains see 8 / 4 / 1 edges, so the scheduled path
+ * executes 13/24 of the baseline's sequential instructions. Combinational
+ * evaluation is identical in both runs and dominates the interpreter tick, so
+ * the end-to-end gain is bounded; the check only rejects a regression beyond
+ * timing noise.
+ *
+ * Tag: [perf][multi_clock] — runs under ctest -L perf
+ */
+
+#include "catch_amalgamated.hpp"
+#include "perf_timer.h"
+#include "ch.hpp"
+#include "component.h"
+#include "core/clock_domain.h"
+#include "core/reg.h"
+#include "core/uint.h"
+#include "device.h"
+#include "simulator.h"
+
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+using namespace ch;
+using namespace ch::core;
+
+namespace {
+
+constexpr int REGS = 50;
+
+class TriDomainRegBank : public ch::Component {
+public:
+    __io(ch_out<ch_uint<16>> core_sum; ch_out<ch_uint<16>> bus_sum;
+         ch_out<ch_uint<16>> periph_sum;)
+
+    TriDomainRegBank(ch::Component *p = nullptr,
+                     const std::string &n = "tri_domain_bank")
+        : ch::Component(p, n) {}
+
+    void create_ports() override { new (io_storage_) io_type; }
+
+    void describe() override {
+        io().core_sum = bank();
+        {
+            ch_clock_domain cd(ch_create_clock("bus_clk"));
+            io().bus_sum = bank();
+        }
+        {
+            ch_clock_domain cd(ch_create_clock("periph_clk"));
+            io().periph_sum = bank();
+        }
+    }
+
+private:
+    // REGS 个自增寄存器，输出最后一个，保持组合逻辑与寄存器数量同阶
+    ch_uint<16> bank() {
+        std::vector<std::unique_ptr<ch_reg<ch_uint<16>>>> regs;
+        for (int i = 0; i < REGS; ++i) {
+            regs.push_back(std::make_unique<ch_reg<ch_uint<16>>>(0_d, "r"));
+            (*regs.back())->next = *regs.back() + 1_d;
+        }
+        return *regs.back();
+    }
+};
+
+double time_median_us(const std::function<void()> &fn, int measured) {
+    std::vector<double> s;
+    for (int i = 0; i < measured; ++i) {
+        PerfTimer t;
+        t.start();
+        fn();
+        t.stop();
+        s.push_back(t.elapsed_us());
+    }
+    std::sort(s.begin(), s.end());
+    return s[s.size() / 2];
+}
+
+double run_window_us(bool skip_idle, uint64_t window) {
+    ch_device<TriDomainRegBank> dev;
+    Simulator sim(dev.context());
+    sim.set_jit_enabled(false);
+    sim.set_skip_idle_domains(skip_idle);
+    sim.set_clock_period("default_clock", 1);
+    sim.set_clock_period("bus_clk", 2);
+    sim.set_clock_period("periph_clk", 8);
+    sim.run_for(window); // warm-up
+    double us = time_median_us([&] { sim.run_for(window); }, 5);
+
+    // 两种路径结果必须一致
+    uint64_t total = 6 * window;
+    REQUIRE(static_cast<uint64_t>(sim.get_port_value(dev.io().core_sum)) ==
+            (total & 0xffff));
+    REQUIRE(static_cast<uint64_t>(sim.get_port_value(dev.io().bus_sum)) ==
+            ((total / 2) & 0xffff));
+    REQUIRE(static_cast<uint64_t>(sim.get_port_value(dev.io().periph_sum)) ==
+            ((total / 8) & 0xffff));
+    return us;
+}
+
+} // namespace
+
+TEST_CASE("Multi-clock: skipping idle domains beats evaluating all of them",
+          "[perf][multi_clock]") {
+    const uint64_t window = 200;
+    double baseline_us = run_window_us(false, window);
+    double scheduled_us = run_window_us(true, window);
+
+    std::cout << "[PERF] multi-clock 3 domains x " << REGS
+              << " regs, window=" << window << ": all-domains "
+              << baseline_us << " us, skip-idle " << scheduled_us
+              << " us, speedup " << baseline_us / scheduled_us << "x"
+              << std::endl;
+    INFO("baseline_us=" << baseline_us << " scheduled_us=" << scheduled_us);
+    REQUIRE(scheduled_us <= baseline_us * 1.15);
+}
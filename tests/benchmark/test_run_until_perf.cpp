@@ -0,0 +1,117 @@
+/**
+ * @file test_run_until_perf.cpp
+ * @brief ADR-040: run_until() vs the per-tick testbench loop.
+ *
+ * The riscv-mini testbenches wait for tohost as
+ *   for (...) { sim.tick(); if (sim.get_port_value(x) != 0) break; }
+ * which costs a progress-report clock read, a data_map_ lookup and an
+ * sdata_type copy per cycle on top of the evaluation itself. This test runs
+ * the same wait on a small counter (where that overhead dominates, as in the
+ * short riscv-tests programs) both ways, for the JIT and the interpreter,
+ * and prints ticks/s and the speedup.
+ *
+ * Gate: run_until must reach the same cycle and must not be slower. The
+ * speedup itself depends on the per-tick evaluation cost and is reported,
+ * not asserted.
+ *
+ * Tag: [perf][run_until] — runs under ctest -L perf
+ */
+
+#include "catch_amalgamated.hpp"
+#include "perf_timer.h"
+#include "component.h"
+#include "core/literal.h"
+#include "core/reg.h"
+#include "core/uint.h"
+#include "device.h"
+#include "simulator.h"
+
+#include <algorithm>
+#include <iostream>
+
+using namespace ch::core;
+using ch::Simulator;
+
+namespace {
+
+class WaitCounter : public ch::Component {
+public:
+    __io(ch_in<ch_uint<32>> step; ch_out<ch_uint<32>> count;
+         ch_out<ch_uint<32>> mix;)
+
+    WaitCounter(ch::Component *parent = nullptr,
+                const std::string &name = "wait_counter")
+        : ch::Component(parent, name) {}
+
+    void create_ports() override { new (io_storage_) io_type; }
+
+    void describe() override {
+        ch_reg<ch_uint<32>> acc(0_d, "acc");
+        ch_reg<ch_uint<32>> lfsr(1_d, "lfsr");
+        acc->next = acc + ch_uint<32>(io().step.impl());
+        lfsr->next = (lfsr << 1_d) ^ (lfsr >> 3_d) ^ acc;
+        io().count = acc;
+        io().mix = lfsr;
+    }
+};
+
+constexpr uint64_t kTarget = 200000;
+
+struct Row {
+    uint64_t ticks;
+    double ms;
+};
+
+Row per_tick_loop(bool jit) {
+    ch::ch_device<WaitCounter> dev;
+    Simulator sim(dev.context());
+    sim.set_jit_enabled(jit);
+    sim.set_input_value(dev.io().step, 1);
+    PerfTimer t;
+    t.start();
+    uint64_t n = 0;
+    while (n < 2 * kTarget) {
+        sim.tick();
+        ++n;
+        if (static_cast<uint64_t>(sim.get_port_value(dev.io().count)) ==
+            kTarget) {
+            break;
+        }
+    }
+    t.stop();
+    return {n, t.elapsed_ms()};
+}
+
+Row engine_loop(bool jit) {
+    ch::ch_device<WaitCounter> dev;
+    Simulator sim(dev.context());
+    sim.set_jit_enabled(jit);
+    sim.set_input_value(dev.io().step, 1);
+    sim.watch_equals(dev.io().count, kTarget);
+    PerfTimer t;
+    t.start();
+    const uint64_t n = sim.run_until(2 * kTarget);
+    t.stop();
+    return {n, t.elapsed_ms()};
+}
+
+} // namespace
+
+TEST_CASE("run_until: faster than the per-tick testbench loop",
+          "[perf][run_until]") {
+    for (bool jit : {true, false}) {
+        const Row loop = per_tick_loop(jit);
+        const Row engine = engine_loop(jit);
+        REQUIRE(loop.ticks == kTarget);
+        REQUIRE(engine.ticks == loop.ticks);
+
+        const double speedup = loop.ms / std::max(engine.ms, 1e-6);
+        std::cout << "[run_until] " << (jit ? "jit   " : "interp")
+                  << " per-tick=" << loop.ms << "ms ("
+                  << static_cast<uint64_t>(loop.ticks / loop.ms * 1000.0)
+                  << " ticks/s) run_until=" << engine.ms << "ms ("
+                  << static_cast<uint64_t>(engine.ticks / engine.ms * 1000.0)
+                  << " ticks/s) speedup=" << speedup << "x" << std::endl;
+        CHECK(engine.ms <= loop.ms * 1.05);
+    }
+}
@@ -1,38 +0,0 @@
-// tests/benchmark/verilator_harness_tc07.cpp
-//
-// Verilator `--exe` harness for TC-07 (combinational design: ch_out<ch_uint<8>>
-// fed through an XOR chain generated by perf_main.cpp).
-//
-// This file is NOT compiled by the CppHDL CMake build (see
-// tests/benchmark/CMakeLists.txt — it intentionally omits the harness from
-// BENCHMARK_SOURCES to avoid multiple-main() link errors). It is consumed by
-// `verilator --cc --build --exe` at runtime, which generates Vtop.h from the
-// emitted Verilog and links this harness against it.
-//
-// Generic enough to drive any combinational DUT: argv[1] selects the number of
-// eval() iterations (default 1000). Clocks/resets are held low because the
-// design has no sequential elements.
-
-#include "Vtop.h"
-
-#include <cstdint>
-#include <cstdlib>
-
-int main(int argc, char** argv) {
-    int ticks = (argc > 1) ? std::atoi(argv[1]) : 1000;
-
-    Vtop* top = new Vtop;
-    top->default_clock = 0;
-    top->default_reset = 0;
-
-    for (int i = 0; i < ticks; ++i) {
-        top->eval();
-    }
-
-    // Sink to prevent the compiler from optimizing away the eval() loop.
-    volatile uint32_t sink = top->top_unnamed_output;
-    (void)sink;
-
-    delete top;
-    return 0;
-}
\ No newline at end of file
@@ -1,56 +0,0 @@
-// tests/benchmark/verilator_harness_tc08.cpp
-//
-// Verilator `--exe` harness for TC-08 (sequential design: ch_out<ch_uint<8>>
-// feeding a ch_reg<ch_uint<8>> chain generated by perf_main.cpp).
-//
-// Unlike TC-07 (combinational), this DUT has flip-flops, so the harness must
-// drive `default_clock` and `default_reset` explicitly. Verilator's event-
-// driven simulation model processes one clock edge per eval() call, so a full
-// tick requires two evals (low->high and high->low) for the register to
-// capture its next value. The reset pulse runs for one full cycle BEFORE the
-// main loop so every register starts from a known initial state.
-//
-// This file is NOT compiled by the CppHDL CMake build (see
-// tests/benchmark/CMakeLists.txt — it intentionally omits the harness from
-// BENCHMARK_SOURCES to avoid multiple-main() link errors). It is consumed by
-// `verilator --cc --build --exe` at runtime, which generates Vtop.h from the
-// emitted Verilog and links this harness against it.
-//
-// argv[1] selects the number of clock ticks (default 1000).
-
-#include "Vtop.h"
-
-#include <cstdint>
-#include <cstdlib>
-
-int main(int argc, char** argv) {
-    int ticks = (argc > 1) ? std::atoi(argv[1]) : 1000;
-
-    Vtop* top = new Vtop;
-
-    // Reset pulse: hold reset=1 for one full clock cycle so every register
-    // latches the reset value. Two evals = one rising + one falling edge.
-    top->default_clock = 0;
-    top->default_reset = 1;
-    top->eval();
-    top->default_clock = 1;
-    top->eval();
-    top->default_reset = 0;
-
-    // Main loop: toggle clock per tick. Each iteration is a full clock cycle
-    // (low->high->low), which is what Verilator needs for sequential logic to
-    // advance by one cycle.
-    for (int i = 0; i < ticks; ++i) {
-        top->default_clock = 0;
-        top->eval();
-        top->default_clock = 1;
-        top->eval();
-    }
-
-    // Sink to prevent the compiler from optimizing away the eval() loop.
-    volatile uint32_t sink = top->top_unnamed_output;
-    (void)sink;
-
-    delete top;
-    return 0;
-}
@@ -5,7 +5,9 @@
 // verilog_source + harness_source) to amortize the ~5-30s first-build
 // cost across reruns.
 //
-// Used by perf_main.cpp (TC-07/TC-08 three-way comparison). See
+// Used by test_verilator_integration.cpp to validate the Verilator
+// toolchain itself; perf_main.cpp drives TC-07/08 in-process through
+// ch::VerilatorBackend instead (ADR-035 Phase 3.7). See
 // docs/superpowers/specs/2026-06-08-perf-tests-jit-verilator-comparison-design.md
 // for design intent.
 
@@ -0,0 +1,291 @@
+// tests/test_checkpoint.cpp
+// ADR-038: 检查点保存/恢复与 fork —— 恢复或分叉后的仿真必须与不中断的
+// 参考仿真逐拍一致（寄存器、存储器内容、同步读端口输出、时钟域状态）。
+#include "catch_amalgamated.hpp"
+#include "component.h"
+#include "core/literal.h"
+#include "core/mem.h"
+#include "core/reg.h"
+#include "core/uint.h"
+#include "device.h"
+#include "simulator.h"
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace ch;
+using namespace ch::core;
+
+namespace {
+
+// 累加器 + 一块由累加器低位寻址写入、由输入地址同步读出的存储器
+class CheckpointDesign : public ch::Component {
+public:
+    __io(ch_in<ch_uint<16>> din; ch_in<ch_uint<6>> raddr; ch_in<ch_bool> we;
+         ch_out<ch_uint<16>> count; ch_out<ch_uint<16>> rdata;)
+
+    CheckpointDesign(ch::Component *parent = nullptr,
+                     const std::string &name = "checkpoint_design")
+        : ch::Component(parent, name) {}
+
+    void create_ports() override { new (io_storage_) io_type; }
+
+    void describe() override {
+        ch_reg<ch_uint<16>> acc(0_d, "acc");
+        acc->next = acc + ch_uint<16>(io().din.impl());
+
+        ch_mem<ch_uint<16>, 64> mem("scratch");
+        mem.write(bits<5, 0>(acc), acc, ch_bool(io().we.impl()));
+        auto rd = mem.sread(ch_uint<6>(io().raddr.impl()), ch_bool(true));
+
+        io().count = acc;
+        io().rdata = rd;
+    }
+};
+
+// 另一个结构不同的设计，用于检查设计哈希
+class OtherDesign : public ch::Component {
+public:
+    __io(ch_in<ch_uint<16>> din; ch_out<ch_uint<16>> count;)
+
+    OtherDesign(ch::Component *parent = nullptr,
+                const std::string &name = "other_design")
+        : ch::Component(parent, name) {}
+
+    void create_ports() override { new (io_storage_) io_type; }
+
+    void describe() override {
+        ch_reg<ch_uint<16>> acc(0_d, "acc");
+        acc->next = acc ^ ch_uint<16>(io().din.impl());
+        io().count = acc;
+    }
+};
+
+struct Sample {
+    uint64_t count;
+    uint64_t rdata;
+    bool operator==(const Sample &other) const {
+        return count == other.count && rdata == other.rdata;
+    }
+};
+
+// 以 cycle 为种子驱动一拍；salt 让分叉后的两条路径输入不同
+Sample step(Simulator &sim, ch_device<CheckpointDesign> &dev, uint64_t cycle,
+            uint64_t salt = 0) {
+    sim.set_input_value(dev.io().din, (cycle * 7 + 3 + salt) & 0xffff);
+    sim.set_input_value(dev.io().raddr, (cycle * 5) & 0x3f);
+    sim.set_input_value(dev.io().we, (cycle % 3) != 0);
+    sim.tick();
+    return {static_cast<uint64_t>(sim.get_port_value(dev.io().count)),
+            static_cast<uint64_t>(sim.get_port_value(dev.io().rdata))};
+}
+
+std::string temp_path(const char *name) {
+    return std::string("checkpoint_") + name + ".chk";
+}
+
+} // namespace
+
+TEST_CASE("Checkpoint: restore reproduces the uninterrupted run",
+          "[checkpoint]") {
+    ch_device<CheckpointDesign> ref_dev;
+    Simulator ref(ref_dev.context());
+    const std::string path = temp_path("restore");
+
+    for (uint64_t cycle = 0; cycle < 100; ++cycle) {
+        step(ref, ref_dev, cycle);
+    }
+    REQUIRE(ref.save_checkpoint(path));
+
+    std::vector<Sample> expected;
+    for (uint64_t cycle = 100; cycle < 160; ++cycle) {
+        expected.push_back(step(ref, ref_dev, cycle));
+    }
+
+    SECTION("into a fresh simulator of the same design") {
+        ch_device<CheckpointDesign> dev;
+        Simulator sim(dev.context());
+        REQUIRE(sim.design_hash() == ref.design_hash());
+        REQUIRE(sim.restore_checkpoint(path));
+        for (uint64_t cycle = 100; cycle < 160; ++cycle) {
+            REQUIRE(step(sim, dev, cycle) == expected[cycle - 100]);
+        }
+    }
+
+    SECTION("rewinding the same simulator") {
+        REQUIRE(ref.restore_checkpoint(path));
+        for (uint64_t cycle = 100; cycle < 160; ++cycle) {
+            REQUIRE(step(ref, ref_dev, cycle) == expected[cycle - 100]);
+        }
+    }
+
+    SECTION("with the JIT disabled in the restored simulator") {
+        ch_device<CheckpointDesign> dev;
+        Simulator sim(dev.context());
+        sim.set_jit_enabled(false);
+        REQUIRE(sim.restore_checkpoint(path));
+        for (uint64_t cycle = 100; cycle < 160; ++cycle) {
+            REQUIRE(step(sim, dev, cycle) == expected[cycle - 100]);
+        }
+    }
+
+    std::remove(path.c_str());
+}
+
+TEST_CASE("Checkpoint: multi-clock schedule state is restored",
+          "[checkpoint][multiclock]") {
+    ch_device<CheckpointDesign> ref_dev;
+    Simulator ref(ref_dev.context());
+    REQUIRE(ref.set_clock_period("default_clock", 3, 1));
+    const std::string path = temp_path("multiclock");
+
+    for (uint64_t cycle = 0; cycle < 20; ++cycle) {
+        step(ref, ref_dev, cycle);
+    }
+    REQUIRE(ref.save_checkpoint(path));
+    const uint64_t saved_time = ref.sim_time();
+    std::vector<Sample> expected;
+    for (uint64_t cycle = 20; cycle < 40; ++cycle) {
+        expected.push_back(step(ref, ref_dev, cycle));
+    }
+
+    ch_device<CheckpointDesign> dev;
+    Simulator sim(dev.context());
+    REQUIRE(sim.restore_checkpoint(path));
+    REQUIRE(sim.is_multi_clock());
+    REQUIRE(sim.sim_time() == saved_time);
+    for (uint64_t cycle = 20; cycle < 40; ++cycle) {
+        REQUIRE(step(sim, dev, cycle) == expected[cycle - 20]);
+    }
+    REQUIRE(sim.clock_edge_count("default_clock") ==
+            ref.clock_edge_count("default_clock"));
+
+    std::remove(path.c_str());
+}
+
+TEST_CASE("Checkpoint: mismatched or corrupted files are rejected",
+          "[checkpoint]") {
+    ch_device<CheckpointDesign> dev;
+    Simulator sim(dev.context());
+    const std::string path = temp_path("reject");
+    for (uint64_t cycle = 0; cycle < 10; ++cycle) {
+        step(sim, dev, cycle);
+    }
+    REQUIRE(sim.save_checkpoint(path));
+    const Sample before = {static_cast<uint64_t>(sim.get_port_value(dev.io().count)),
+                           static_cast<uint64_t>(sim.get_port_value(dev.io().rdata))};
+
+    SECTION("different design") {
+        ch_device<OtherDesign> other_dev;
+        Simulator other(other_dev.context());
+        REQUIRE(other.design_hash() != sim.design_hash());
+        REQUIRE_FALSE(other.restore_checkpoint(path));
+    }
+
+    SECTION("truncated file leaves the simulator untouched") {
+        std::string bytes;
+        {
+            std::ifstream in(path, std::ios::binary);
+            bytes.assign(std::istreambuf_iterator<char>(in),
+                         std::istreambuf_iterator<char>());
+        }
+        {
+            std::ofstream out(path, std::ios::binary | std::ios::trunc);
+            out.write(bytes.data(),
+                      static_cast<std::streamsize>(bytes.size() / 2));
+        }
+        step(sim, dev, 10);
+        const Sample after = {static_cast<uint64_t>(sim.get_port_value(dev.io().count)),
+                              static_cast<uint64_t>(sim.get_port_value(dev.io().rdata))};
+        REQUIRE_FALSE(sim.restore_checkpoint(path));
+        REQUIRE(static_cast<uint64_t>(sim.get_port_value(dev.io().count)) ==
+                after.count);
+        REQUIRE_FALSE(after == before);
+    }
+
+    SECTION("missing file") {
+        REQUIRE_FALSE(sim.restore_checkpoint(temp_path("does_not_exist")));
+    }
+
+    std::remove(path.c_str());
+}
+
+TEST_CASE("Checkpoint: fork branches independently from a warm simulator",
+          "[checkpoint][fork]") {
+    ch_device<CheckpointDesign> dev;
+    Simulator boot(dev.context());
+    for (uint64_t cycle = 0; cycle < 80; ++cycle) {
+        step(boot, dev, cycle);
+    }
+
+    ch_device<CheckpointDesign> ref_dev;
+    Simulator ref(ref_dev.context());
+    for (uint64_t cycle = 0; cycle < 80; ++cycle) {
+        step(ref, ref_dev, cycle);
+    }
+
+    auto child_a = boot.fork();
+    auto child_b = boot.fork();
+    REQUIRE(child_a);
+    REQUIRE(child_b);
+    REQUIRE(child_a->is_jit_compiled() == boot.is_jit_compiled());
+
+    // child_a 走参考路径，child_b 走不同输入；互相之间以及与 boot 互不影响
+    for (uint64_t cycle = 80; cycle < 140; ++cycle) {
+        const Sample expected = step(ref, ref_dev, cycle);
+        REQUIRE(step(*child_a, dev, cycle) == expected);
+        step(*child_b, dev, cycle, 0x55);
+    }
+    REQUIRE(static_cast<uint64_t>(child_b->get_port_value(dev.io().count)) !=
+            static_cast<uint64_t>(child_a->get_port_value(dev.io().count)));
+
+    // boot 本身没有前进：从它再走参考路径依旧一致
+    ch_device<CheckpointDesign> ref2_dev;
+    Simulator ref2(ref2_dev.context());
+    for (uint64_t cycle = 0; cycle < 80; ++cycle) {
+        step(ref2, ref2_dev, cycle);
+    }
+    for (uint64_t cycle = 80; cycle < 100; ++cycle) {
+        REQUIRE(step(boot, dev, cycle) == step(ref2, ref2_dev, cycle));
+    }
+}
+
+TEST_CASE("Checkpoint: fork and restore with JIT-compiled code",
+          "[checkpoint][fork][jit]") {
+    ch_device<OtherDesign> dev;
+    Simulator boot(dev.context());
+    auto drive = [&](Simulator &sim, uint64_t cycle) {
+        sim.set_input_value(dev.io().din, (cycle * 13 + 1) & 0xffff);
+        sim.tick();
+        return static_cast<uint64_t>(sim.get_port_value(dev.io().count));
+    };
+    for (uint64_t cycle = 0; cycle < 30; ++cycle) {
+        drive(boot, cycle);
+    }
+
+    const std::string path = temp_path("jit");
+    REQUIRE(boot.save_checkpoint(path));
+    auto child = boot.fork();
+    REQUIRE(child);
+    REQUIRE(child->is_jit_compiled() == boot.is_jit_compiled());
+
+    std::vector<uint64_t> expected;
+    for (uint64_t cycle = 30; cycle < 60; ++cycle) {
+        expected.push_back(drive(boot, cycle));
+    }
+    for (uint64_t cycle = 30; cycle < 60; ++cycle) {
+        REQUIRE(drive(*child, cycle) == expected[cycle - 30]);
+    }
+
+    // 父仿真器先析构，子仿真器仍持有已编译代码
+    auto grandchild = child->fork();
+    child.reset();
+    REQUIRE(grandchild->restore_checkpoint(path));
+    for (uint64_t cycle = 30; cycle < 60; ++cycle) {
+        REQUIRE(drive(*grandchild, cycle) == expected[cycle - 30]);
+    }
+
+    std::remove(path.c_str());
+}
@@ -0,0 +1,146 @@
+// tests/test_logger.cpp
+// 日志级别裁剪：编译期低于 CH_LOG_MIN_LEVEL 的调用不求值参数，运行期被
+// 关闭的级别同样不求值；异步输出在多线程下不丢失 warning 以上的消息，
+// 并按 flush_log() 的约定全部写出。
+#include "catch_amalgamated.hpp"
+#include "logger.h"
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+int evaluations = 0;
+
+int bump() { return ++evaluations; }
+
+// 把 fd 1/2 临时重定向到文件，析构时恢复
+class CaptureOutput {
+public:
+    explicit CaptureOutput(const std::string &path) : path_(path) {
+        std::fflush(stdout);
+        std::fflush(stderr);
+        saved_out_ = dup(1);
+        saved_err_ = dup(2);
+        FILE *f = std::fopen(path.c_str(), "w");
+        dup2(fileno(f), 1);
+        dup2(fileno(f), 2);
+        std::fclose(f);
+    }
+    ~CaptureOutput() { restore(); }
+
+    void restore() {
+        if (saved_out_ < 0)
+            return;
+        std::fflush(stdout);
+        std::fflush(stderr);
+        dup2(saved_out_, 1);
+        dup2(saved_err_, 2);
+        close(saved_out_);
+        close(saved_err_);
+        saved_out_ = saved_err_ = -1;
+    }
+
+    size_t count_lines_with(const std::string &needle) const {
+        std::ifstream in(path_);
+        std::string line;
+        size_t n = 0;
+        while (std::getline(in, line)) {
+            if (line.find(needle) != std::string::npos)
+                ++n;
+        }
+        return n;
+    }
+
+private:
+    std::string path_;
+    int saved_out_ = -1;
+    int saved_err_ = -1;
+};
+
+} // namespace
+
+TEST_CASE("Logger: runtime level gates argument evaluation", "[logger]") {
+    const auto saved = ch::get_log_level();
+    evaluations = 0;
+
+    ch::set_log_level(ch::log_level::error);
+    CHINFO("value %d", bump());
+    CHWARN("value %d", bump());
+    REQUIRE(evaluations == 0);
+
+    {
+        CaptureOutput capture("logger_runtime.log");
+        CHERROR("value %d", bump());
+        capture.restore();
+        REQUIRE(capture.count_lines_with("value 1") == 1);
+    }
+    REQUIRE(evaluations == 1);
+
+    ch::set_log_off();
+    CHERROR("value %d", bump());
+    CHFATAL("value %d", bump());
+    REQUIRE(evaluations == 1);
+
+    ch::set_log_level(saved);
+    std::remove("logger_runtime.log");
+}
+
+TEST_CASE("Logger: levels below CH_LOG_MIN_LEVEL are compiled out",
+          "[logger]") {
+    const auto saved = ch::get_log_level();
+    evaluations = 0;
+    ch::set_log_level(ch::log_level::debug);
+    CHDBG("value %d", bump());
+    CHDBG_VAR(evaluations);
+    if constexpr (CH_LOG_MIN_LEVEL > 0) {
+        // 运行期阈值再低也不会求值：调用在编译期就已经丢弃
+        REQUIRE(evaluations == 0);
+    } else {
+        REQUIRE(evaluations == 1);
+    }
+    ch::set_log_level(saved);
+}
+
+TEST_CASE("Logger: async sink delivers every enabled message",
+          "[logger][async]") {
+    const auto saved = ch::get_log_level();
+    ch::set_log_level(ch::log_level::info);
+    constexpr int kThreads = 4;
+    constexpr int kPerThread = 2000;
+
+    CaptureOutput capture("logger_async.log");
+    ch::set_async_logging(true);
+    REQUIRE(ch::async_logging());
+    const uint64_t dropped_before =
+        ch::detail::async_log_sink::instance().dropped();
+
+    std::vector<std::thread> producers;
+    for (int t = 0; t < kThreads; ++t) {
+        producers.emplace_back([t] {
+            for (int i = 0; i < kPerThread; ++i) {
+                // warning 在队列满时不丢弃
+                CHWARN("async-marker %d %d", t, i);
+            }
+        });
+    }
+    for (auto &p : producers) {
+        p.join();
+    }
+    ch::flush_log();
+    ch::set_async_logging(false);
+    REQUIRE_FALSE(ch::async_logging());
+    capture.restore();
+
+    REQUIRE(ch::detail::async_log_sink::instance().dropped() ==
+            dropped_before);
+    REQUIRE(capture.count_lines_with("async-marker") ==
+            static_cast<size_t>(kThreads * kPerThread));
+
+    ch::set_log_level(saved);
+    std::remove("logger_async.log");
+}
@@ -0,0 +1,205 @@
+// tests/test_multi_clock.cpp
+// ADR-036: 多时钟域调度 —— 时钟域划分、按周期/相位推进、per-domain JIT
+// 函数（tick_seq_<domain>）以及 async_fifo 跨时钟域传输。
+#include "catch_amalgamated.hpp"
+#include "chlib/fifo.h"
+#include "component.h"
+#include "core/clock_domain.h"
+#include "core/reg.h"
+#include "core/uint.h"
+#include "device.h"
+#include "simulator.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using namespace ch;
+using namespace ch::core;
+
+namespace {
+
+// 三个时钟域各一个自由计数器：core 用默认时钟，bus/periph 显式创建
+class TriDomainCounters : public ch::Component {
+public:
+    __io(ch_out<ch_uint<16>> core_count; ch_out<ch_uint<16>> bus_count;
+         ch_out<ch_uint<16>> periph_count;)
+
+    TriDomainCounters(ch::Component *parent = nullptr,
+                      const std::string &name = "tri_domain")
+        : ch::Component(parent, name) {}
+
+    void create_ports() override { new (io_storage_) io_type; }
+
+    void describe() override {
+        ch_reg<ch_uint<16>> core_cnt(0_d, "core_cnt");
+        core_cnt->next = core_cnt + 1_d;
+        io().core_count = core_cnt;
+
+        {
+            ch_clock_domain cd(ch_create_clock("bus_clk"));
+            ch_reg<ch_uint<16>> bus_cnt(0_d, "bus_cnt");
+            bus_cnt->next = bus_cnt + 1_d;
+            io().bus_count = bus_cnt;
+        }
+
+        {
+            ch_clock_domain cd(ch_create_clock("periph_clk"));
+            ch_reg<ch_uint<16>> periph_cnt(0_d, "periph_cnt");
+            periph_cnt->next = periph_cnt + 1_d;
+            io().periph_count = periph_cnt;
+        }
+    }
+};
+
+// 写域按 full 反压写入 1..N，读域在每次出队时检查数据顺序
+template <unsigned N> class AsyncFifoLoopback : public ch::Component {
+public:
+    __io(ch_out<ch_uint<8>> read_count; ch_out<ch_bool> error;)
+
+    AsyncFifoLoopback(ch::Component *parent = nullptr,
+                      const std::string &name = "async_fifo_loopback")
+        : ch::Component(parent, name) {}
+
+    void create_ports() override { new (io_storage_) io_type; }
+
+    void describe() override {
+        auto *wr_clk = ch_create_clock("wr_clk");
+        auto *rd_clk = ch_create_clock("rd_clk");
+
+        ch_clock_domain wr_domain(wr_clk);
+        ch_reg<ch_uint<8>> next_data(1_d, "next_data");
+        ch_bool wren = next_data <= make_literal<N>();
+
+        auto fifo = chlib::async_fifo<8, 2>(wr_clk, wren, next_data, rd_clk,
+                                            ch_bool(true));
+        ch_bool accepted = select(wren, ch_bool(!fifo.full), ch_bool(false));
+        next_data->next = select(accepted, next_data + 1_d, next_data);
+
+        {
+            ch_clock_domain cd(rd_clk);
+            ch_reg<ch_uint<8>> expected(1_d, "expected");
+            ch_reg<ch_uint<8>> count(0_d, "count");
+            ch_reg<ch_bool> err(false, "err");
+            ch_bool pop = !fifo.empty;
+            expected->next = select(pop, expected + 1_d, expected);
+            count->next = select(pop, count + 1_d, count);
+            err->next = select(pop, ch_bool(err | (fifo.q != expected)), err);
+            io().read_count = count;
+            io().error = err;
+        }
+    }
+};
+
+} // namespace
+
+TEST_CASE("Multi-clock: legacy tick keeps all domains in lockstep",
+          "[multi_clock]") {
+    ch_device<TriDomainCounters> dev;
+    Simulator sim(dev.context());
+
+    REQUIRE(sim.clock_domain_count() == 3);
+    REQUIRE_FALSE(sim.is_multi_clock());
+
+    sim.tick(5);
+    REQUIRE(static_cast<uint64_t>(sim.get_port_value(dev.io().core_count)) == 5);
+    REQUIRE(static_cast<uint64_t>(sim.get_port_value(dev.io().bus_count)) == 5);
+    REQUIRE(static_cast<uint64_t>(sim.get_port_value(dev.io().periph_count)) ==
+            5);
+}
+
+TEST_CASE("Multi-clock: domains advance at their own period",
+          "[multi_clock]") {
+    for (bool jit : {false, true}) {
+        DYNAMIC_SECTION((jit ? "jit" : "interpreter")) {
+            ch_device<TriDomainCounters> dev;
+            Simulator sim(dev.context());
+            sim.set_jit_enabled(jit);
+
+            REQUIRE(sim.set_clock_period("default_clock", 1));
+            REQUIRE(sim.set_clock_period("bus_clk", 2));
+            REQUIRE(sim.set_clock_period("periph_clk", 8));
+            REQUIRE(sim.is_multi_clock());
+
+            sim.run_for(16);
+            REQUIRE(sim.sim_time() == 16);
+            REQUIRE(static_cast<uint64_t>(
+                        sim.get_port_value(dev.io().core_count)) == 16);
+            REQUIRE(static_cast<uint64_t>(
+                        sim.get_port_value(dev.io().bus_count)) == 8);
+            REQUIRE(static_cast<uint64_t>(
+                        sim.get_port_value(dev.io().periph_count)) == 2);
+            REQUIRE(sim.clock_edge_count("default_clock") == 16);
+            REQUIRE(sim.clock_edge_count("bus_clk") == 8);
+            REQUIRE(sim.clock_edge_count("periph_clk") == 2);
+
+            // tick() 处理下一个沿事件：t=16 时三个域同时有沿
+            sim.tick();
+            REQUIRE(sim.sim_time() == 16);
+            REQUIRE(static_cast<uint64_t>(
+                        sim.get_port_value(dev.io().periph_count)) == 3);
+            sim.tick();
+            REQUIRE(sim.sim_time() == 17);
+            REQUIRE(static_cast<uint64_t>(
+                        sim.get_port_value(dev.io().core_count)) == 18);
+            REQUIRE(static_cast<uint64_t>(
+                        sim.get_port_value(dev.io().bus_count)) == 9);
+        }
+    }
+}
+
+TEST_CASE("Multi-clock: phase offset and unconfigured domains",
+          "[multi_clock]") {
+    ch_device<TriDomainCounters> dev;
+    Simulator sim(dev.context());
+
+    // 只配置 periph：默认域与 bus 沿用默认周期 1
+    REQUIRE(sim.set_clock_period("periph_clk", 4, 2));
+    sim.run_for(8); // periph 沿在 t=2, 6
+    REQUIRE(static_cast<uint64_t>(sim.get_port_value(dev.io().periph_count)) ==
+            2);
+    REQUIRE(static_cast<uint64_t>(sim.get_port_value(dev.io().bus_count)) == 8);
+
+    REQUIRE_FALSE(sim.set_clock_period("no_such_clock", 2));
+    REQUIRE_FALSE(sim.set_clock_period("bus_clk", 0));
+}
+
+TEST_CASE("Multi-clock: JIT emits one tick_seq function per domain",
+          "[multi_clock][jit]") {
+    ch_device<TriDomainCounters> dev;
+    ch::jit::JitCompiler jit;
+    if (!jit.is_available()) {
+        SKIP("LLVM JIT not available");
+    }
+
+    auto result = jit.compile(dev.context());
+    REQUIRE(result.result == ch::jit::JitResult::SUCCESS);
+
+    std::vector<std::string> names;
+    for (const auto &domain : jit.seq_domains()) {
+        names.push_back(domain.func_name);
+        CHECK(domain.func != nullptr);
+        CHECK(domain.ir_instr_count > 0);
+    }
+    REQUIRE(names.size() == 3);
+    CHECK(names[0] == "tick_seq");
+    CHECK(std::find(names.begin(), names.end(), "tick_seq_bus_clk") !=
+          names.end());
+    CHECK(std::find(names.begin(), names.end(), "tick_seq_periph_clk") !=
+          names.end());
+}
+
+TEST_CASE("Multi-clock: async_fifo transfers data across domains in order",
+          "[multi_clock][fifo]") {
+    constexpr unsigned N = 20;
+    ch_device<AsyncFifoLoopback<N>> dev;
+    Simulator sim(dev.context());
+
+    REQUIRE(sim.set_clock_period("wr_clk", 3));
+    REQUIRE(sim.set_clock_period("rd_clk", 5, 1));
+    sim.run_for(600);
+
+    REQUIRE(static_cast<uint64_t>(sim.get_port_value(dev.io().read_count)) ==
+            N);
+    REQUIRE(static_cast<uint64_t>(sim.get_port_value(dev.io().error)) == 0);
+}
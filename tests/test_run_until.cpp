@@ -0,0 +1,165 @@
+// tests/test_run_until.cpp
+// ADR-040: run_until / watch / on_change —— 条件推进停下的那一拍、
+// 信号值与回调次数都必须和逐拍 tick() + get_port_value() 的参考循环一致。
+#include "catch_amalgamated.hpp"
+#include "component.h"
+#include "core/literal.h"
+#include "core/reg.h"
+#include "core/uint.h"
+#include "device.h"
+#include "simulator.h"
+
+#include <cstdint>
+#include <vector>
+
+using namespace ch;
+using namespace ch::core;
+
+namespace {
+
+// 计数器：count 每拍加 step，flag 为 count 的第 4 位
+class WatchCounter : public ch::Component {
+public:
+    __io(ch_in<ch_uint<16>> step; ch_out<ch_uint<16>> count;
+         ch_out<ch_bool> flag;)
+
+    WatchCounter(ch::Component *parent = nullptr,
+                 const std::string &name = "watch_counter")
+        : ch::Component(parent, name) {}
+
+    void create_ports() override { new (io_storage_) io_type; }
+
+    void describe() override {
+        ch_reg<ch_uint<16>> acc(0_d, "acc");
+        acc->next = acc + ch_uint<16>(io().step.impl());
+        io().count = acc;
+        io().flag = bit_select<4>(acc);
+    }
+};
+
+uint64_t count_of(Simulator &sim, ch_device<WatchCounter> &dev) {
+    return static_cast<uint64_t>(sim.get_port_value(dev.io().count));
+}
+
+// 参考：逐拍 tick()，直到 count == target
+uint64_t ticks_until_count(uint64_t target, uint64_t max_ticks, bool jit) {
+    ch_device<WatchCounter> dev;
+    Simulator sim(dev.context());
+    sim.set_jit_enabled(jit);
+    sim.set_input_value(dev.io().step, 3);
+    for (uint64_t n = 1; n <= max_ticks; ++n) {
+        sim.tick();
+        if (count_of(sim, dev) == target) {
+            return n;
+        }
+    }
+    return max_ticks;
+}
+
+} // namespace
+
+TEST_CASE("run_until: stops on the same cycle as a per-tick loop",
+          "[run_until]") {
+    const bool jit = GENERATE(true, false);
+    const uint64_t expected = ticks_until_count(300, 1000, jit);
+    REQUIRE(expected < 1000);
+
+    ch_device<WatchCounter> dev;
+    Simulator sim(dev.context());
+    sim.set_jit_enabled(jit);
+    sim.set_input_value(dev.io().step, 3);
+    const auto id = sim.watch_equals(dev.io().count, 300);
+    REQUIRE(id >= 0);
+
+    REQUIRE(sim.run_until(1000) == expected);
+    REQUIRE(sim.last_stop_watch() == id);
+    REQUIRE(count_of(sim, dev) == 300);
+
+    // 再推进：条件仍然成立时下一拍就停，移除后跑满
+    REQUIRE(sim.remove_watch(id));
+    REQUIRE_FALSE(sim.remove_watch(id));
+    REQUIRE(sim.run_until(10) == 10);
+    REQUIRE(sim.last_stop_watch() == -1);
+    REQUIRE(count_of(sim, dev) == 330);
+}
+
+TEST_CASE("run_until: changed / not_equals / predicate", "[run_until]") {
+    ch_device<WatchCounter> dev;
+    Simulator sim(dev.context());
+    sim.set_input_value(dev.io().step, 1);
+
+    SECTION("changed is relative to the start of each run") {
+        const auto id = sim.watch_changed(dev.io().flag);
+        // count 到 16 时 flag 从 0 变 1，到 32 时变回 0
+        REQUIRE(sim.run_until(100) == 16);
+        REQUIRE(sim.last_stop_watch() == id);
+        REQUIRE(count_of(sim, dev) == 16);
+        REQUIRE(sim.run_until(100) == 16);
+        REQUIRE(count_of(sim, dev) == 32);
+    }
+
+    SECTION("first watch in registration order wins") {
+        const auto late = sim.watch_not_equals(dev.io().flag, 0);
+        const auto early = sim.watch_equals(dev.io().count, 16);
+        REQUIRE(sim.run_until(100) == 16);
+        REQUIRE(sim.last_stop_watch() == late);
+        (void)early;
+    }
+
+    SECTION("predicate") {
+        uint64_t calls = 0;
+        const uint64_t n = sim.run_until(
+            [&] { return ++calls == 25; }, 100);
+        REQUIRE(n == 25);
+        REQUIRE(count_of(sim, dev) == 25);
+        REQUIRE(sim.last_stop_watch() == -1);
+    }
+
+    SECTION("timeout") {
+        sim.watch_equals(dev.io().count, 0xffff);
+        REQUIRE(sim.run_until(50) == 50);
+        REQUIRE(sim.last_stop_watch() == -1);
+        REQUIRE(count_of(sim, dev) == 50);
+    }
+}
+
+TEST_CASE("on_change: callbacks fire only when the value changes",
+          "[run_until][callback]") {
+    ch_device<WatchCounter> dev;
+    Simulator sim(dev.context());
+    sim.set_input_value(dev.io().step, 1);
+
+    std::vector<uint64_t> seen;
+    std::vector<uint64_t> at;
+    sim.on_change(dev.io().flag, [&](uint64_t v) {
+        seen.push_back(v);
+        at.push_back(count_of(sim, dev));
+    });
+
+    sim.tick(40);   // 经过 run_ticks()
+    for (int i = 0; i < 30; ++i) {
+        sim.tick(); // 单拍 tick() 也触发
+    }
+    REQUIRE(seen == std::vector<uint64_t>{1, 0, 1, 0});
+    REQUIRE(at == std::vector<uint64_t>{16, 32, 48, 64});
+
+    // 回调不会让 run_until 停下
+    REQUIRE(sim.run_until([] { return false; }, 20) == 20);
+    REQUIRE(seen.size() == 5);
+
+    sim.clear_watches();
+    sim.tick(40);
+    REQUIRE(seen.size() == 5);
+}
+
+TEST_CASE("run_until: multi-clock mode steps clock edges",
+          "[run_until][multiclock]") {
+    ch_device<WatchCounter> dev;
+    Simulator sim(dev.context());
+    REQUIRE(sim.set_clock_period("default_clock", 4, 0));
+    sim.set_input_value(dev.io().step, 2);
+    sim.watch_equals(dev.io().count, 20);
+    const uint64_t n = sim.run_until(100);
+    REQUIRE(count_of(sim, dev) == 20);
+    REQUIRE(sim.clock_edge_count("default_clock") == n);
+}
@@ -3,8 +3,11 @@
 // Validates:
 //   - SHA-1 cache key is deterministic and version-sensitive
 //   - Verilog generation writes a non-empty file
-//   - verilator --cc --build invocation produces obj_dir/Vtop
-//   - dlopen stub is a safe no-op (real dlopen is Phase 3.2)
+//   - verilator --cc --build invocation produces obj_dir/libVtop.so
+//   - the generated wrapper binds every port; without a loaded model
+//     the backend evaluates through the interpreter lists
+//   - Simulator::set_backend() drives the Verilated model and matches
+//     the interpreter tick for tick (skipped without verilator)
 //   - IEvalBackend interface is correctly implemented
 // mkdtemp() lives in <unistd.h> on macOS (POSIX) but only in <stdlib.h>
 // on glibc with _XOPEN_SOURCE >= 500 | _BSD_SOURCE. Include <unistd.h>
@@ -13,10 +16,12 @@
 #include "catch_amalgamated.hpp"
 #include "ch.hpp"
 #include "codegen_verilog.h"
+#include "component.h"
 #include "core/context.h"
 #include "core/eval_backend.h"
 #include "core/interpreter_backend.h"
 #include "core/verilator_backend.h"
+#include "device.h"
 #include "simulator.h"
 #include <cstdlib>
 #include <cerrno>
@@ -54,6 +59,46 @@ std::string make_temp_dir(const std::string &suffix) {
     return result;
 }
 
+// 16 位累加器 + 40 位计数器（QData 端口）
+class VlAccumulator : public ch::Component {
+public:
+    __io(ch_in<ch_uint<8>> din; ch_out<ch_uint<16>> acc;
+         ch_out<ch_uint<40>> count;)
+
+    VlAccumulator(ch::Component *parent = nullptr,
+                  const std::string &name = "vl_acc")
+        : ch::Component(parent, name) {}
+
+    void create_ports() override { new (io_storage_) io_type; }
+
+    void describe() override {
+        ch_reg<ch_uint<16>> acc(0_d, "acc_r");
+        acc->next = acc + ch_uint<16>(io().din.impl());
+        ch_reg<ch_uint<40>> count(0_d, "count_r");
+        count->next = count + 1_d;
+        io().acc = acc;
+        io().count = count;
+    }
+};
+
+// 驱动两个仿真器 n 拍，逐拍比较输出
+void require_lockstep(Simulator &ref, ch_device<VlAccumulator> &ref_dev,
+                      Simulator &sim, ch_device<VlAccumulator> &dev,
+                      int ticks) {
+    for (int t = 0; t < ticks; ++t) {
+        ref.set_input_value(ref_dev.io().din, (t * 37 + 5) & 0xff);
+        sim.set_input_value(dev.io().din, (t * 37 + 5) & 0xff);
+        ref.tick();
+        sim.tick();
+        INFO("tick " << t);
+        REQUIRE(static_cast<uint64_t>(sim.get_port_value(dev.io().acc)) ==
+                static_cast<uint64_t>(ref.get_port_value(ref_dev.io().acc)));
+        REQUIRE(static_cast<uint64_t>(sim.get_port_value(dev.io().count)) ==
+                static_cast<uint64_t>(
+                    ref.get_port_value(ref_dev.io().count)));
+    }
+}
+
 } // namespace
 
 TEST_CASE("VerilatorBackend - SHA1CacheKeyDeterministic",
@@ -170,13 +215,14 @@ TEST_CASE("VerilatorBackend - InvokeVerilatorProducesVtop",
     ch::data_map_t data_map;
     REQUIRE(backend.initialize(ctx.get(), data_map));
 
-    // verilator --cc should produce obj_dir/Vtop. If it didn't
-    // (slow build, tool error, etc.), skip rather than fail — the
-    // architecture is validated by the other tests.
-    std::string obj_vtop = workdir + "/obj_dir/Vtop";
-    INFO("Expected: " + obj_vtop);
-    if (!path_exists(obj_vtop)) {
-        SKIP("verilator did not produce obj_dir/Vtop "
+    REQUIRE_FALSE(backend.verilator_version().empty());
+    REQUIRE(path_exists(workdir + "/cpphdl_wrapper.cpp"));
+    // A cache hit skips the build; otherwise verilator must have
+    // produced obj_dir/libVtop.so.
+    std::string obj_so = workdir + "/obj_dir/libVtop.so";
+    INFO("Expected: " + obj_so);
+    if (!path_exists(obj_so) && !path_exists(backend.compiled_so_path())) {
+        SKIP("verilator did not produce obj_dir/libVtop.so "
              "(likely slow build or tool issue)");
     }
 }
@@ -195,9 +241,7 @@ TEST_CASE("VerilatorBackend - EvalCombinationalDoesNotCrash",
     VerilatorBackend backend(make_temp_dir("_eval"));
     REQUIRE(backend.initialize(ctx.get(), data_map));
 
-    // Phase 3.2-3.3 will fill in the data_map <-> Vtop sync.
-    // For now, eval_combinational is a safe no-op when dlopen is
-    // stubbed.
+    // Empty instruction lists: safe with or without a loaded model.
     REQUIRE_NOTHROW(backend.eval_combinational(
         data_map, empty_list, empty_list));
     REQUIRE_NOTHROW(backend.eval_sequential(data_map, empty_list));
@@ -231,8 +275,8 @@ TEST_CASE("VerilatorBackend - BuildPortAccessTable",
         }
         bool bw_ok = (kv.second.bitwidth == 1) || (kv.second.bitwidth == 8);
         REQUIRE(bw_ok);
-        // Phase 3.3 follow-up: field_ptr resolution (VPI or codegen).
-        REQUIRE(kv.second.field_ptr == nullptr);
+        // field_ptr comes from cpphdl_bind_ports() of the loaded model.
+        REQUIRE((kv.second.field_ptr != nullptr) == backend.model_loaded());
     }
     REQUIRE(found_inputs == 2);
     REQUIRE(found_outputs == 2);
@@ -298,17 +342,14 @@ TEST_CASE("VerilatorBackend - DlopenAndResolveSymbols",
         SKIP("verilator compilation failed (likely slow build)");
     }
 
-    // After initialize() succeeds with a working verilator,
-    // obj_dir/Vtop must exist.
-    std::string vtop_path = workdir + "/obj_dir/Vtop";
-    INFO("Expected Vtop at: " + vtop_path);
-    REQUIRE(path_exists(vtop_path));
-
-    // We can't dlopen a static executable (it's an ELF executable,
-    // not a shared library), so the dlopen step is best-effort.
-    // The production path (--shared -fPIC) will let us dlopen
-    // libVtop.so directly; for now we just verify the binary
-    // exists and was produced by verilator.
+    if (!backend.model_loaded()) {
+        SKIP("verilator did not produce a loadable libVtop.so");
+    }
+    INFO("Loaded: " + backend.compiled_so_path());
+    REQUIRE(path_exists(backend.compiled_so_path()));
+    auto snapshot = backend.port_access_snapshot();
+    REQUIRE(snapshot.size() == 1);
+    REQUIRE(snapshot.begin()->second.field_ptr != nullptr);
 }
 
 // ADR-035 / Phase 2.3: Simulator::set_backend() API conformance.
@@ -426,3 +467,81 @@ TEST_CASE("VerilatorBackend - CompiledSoPathFormat",
     }
     // 当实现演进并填充 compiled_so_path_ 时，CHECK 会触发并验证格式
 }
+
+TEST_CASE("VerilatorBackend - VersionDetectionMissingTool",
+          "[verilator][backend]") {
+    REQUIRE(VerilatorBackend::detect_verilator_version(
+                "cpphdl-no-such-verilator")
+                .empty());
+    if (tool_available("verilator")) {
+        std::string version = VerilatorBackend::detect_verilator_version();
+        INFO(version);
+        REQUIRE(version.rfind("Verilator ", 0) == 0);
+    }
+}
+
+TEST_CASE("VerilatorBackend - WrapperBindsEveryPort",
+          "[verilator][backend][port-access]") {
+    ch_device<VlAccumulator> dev;
+    std::string workdir = make_temp_dir("_wrapper");
+    REQUIRE(!workdir.empty());
+
+    VerilatorBackend backend(workdir, "cpphdl-no-such-verilator");
+    ch::data_map_t data_map;
+    REQUIRE(backend.initialize(dev.context(), data_map));
+    REQUIRE_FALSE(backend.model_loaded());
+    REQUIRE(backend.verilator_version().empty());
+
+    std::ifstream in(workdir + "/cpphdl_wrapper.cpp");
+    std::stringstream ss;
+    ss << in.rdbuf();
+    const std::string wrapper = ss.str();
+    REQUIRE(wrapper.find("cpphdl_bind_ports") != std::string::npos);
+    // default_clock + default_reset + din + acc + count
+    REQUIRE(wrapper.find("return 5u;") != std::string::npos);
+    REQUIRE(wrapper.find("&t->default_clock") != std::string::npos);
+    REQUIRE(wrapper.find("fields[4] = static_cast<void*>(&t->") !=
+            std::string::npos);
+    REQUIRE(wrapper.find("= nullptr;") == std::string::npos);
+}
+
+TEST_CASE("VerilatorBackend - FallbackMatchesInterpreter",
+          "[verilator][backend][simulator]") {
+    // 没有可用模型时，Simulator 委托给后端仍须得到解释器的结果
+    ch_device<VlAccumulator> ref_dev;
+    Simulator ref(ref_dev.context());
+    ref.set_jit_enabled(false);
+
+    ch_device<VlAccumulator> dev;
+    Simulator sim(dev.context());
+    sim.set_backend(std::make_unique<VerilatorBackend>(
+        make_temp_dir("_fallback"), "cpphdl-no-such-verilator"));
+    REQUIRE(sim.active_backend_name() == "verilator");
+
+    require_lockstep(ref, ref_dev, sim, dev, 50);
+}
+
+TEST_CASE("VerilatorBackend - VerilatedModelMatchesInterpreter",
+          "[verilator][backend][simulator][external]") {
+    if (!tool_available("verilator")) {
+        SKIP("verilator not installed");
+    }
+    ch_device<VlAccumulator> ref_dev;
+    Simulator ref(ref_dev.context());
+    ref.set_jit_enabled(false);
+
+    ch_device<VlAccumulator> dev;
+    Simulator sim(dev.context());
+    auto backend = std::make_unique<VerilatorBackend>(make_temp_dir("_model"));
+    auto *vl = backend.get();
+    sim.set_backend(std::move(backend));
+    if (!vl->model_loaded()) {
+        SKIP("verilator compilation failed (likely slow build)");
+    }
+    require_lockstep(ref, ref_dev, sim, dev, 200);
+
+    // reset() 重建 Vtop 实例，寄存器回到初值
+    sim.reset();
+    ref.reset();
+    require_lockstep(ref, ref_dev, sim, dev, 20);
+}